@@ -0,0 +1,106 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "ast.h"
+#include "lexer.h"
+#include "parser.h"
+#include "token.h"
+
+// Every allocation in this binary goes through here, so the counts below
+// are exact rather than sampled.
+static size_t allocations = 0;
+
+void *operator new(size_t size) {
+  allocations++;
+  if (void *p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// Pinned per-token allocation ceilings for the script below. Lower them when
+// the front end gets cheaper, never raise them without a reason.
+static const double maxLexerAllocationsPerToken = 0.001;
+static const double maxParserAllocationsPerToken = 0.759;
+
+static std::string representativeScript() {
+  std::string snippet = "let five = 5;\n"
+                        "let ten = 10;\n"
+                        "let accumulated_result = 838383;\n"
+                        "let add = fn(x, y) { x + y; };\n"
+                        "return add;\n"
+                        "accumulated_result;\n"
+                        "let a_long_descriptive_identifier = five;\n"
+                        "if (5 < 10) { return true; } else { return false; }\n"
+                        "10 == 10;\n"
+                        "10 != 9;\n";
+  std::string script{};
+  for (int i = 0; i < 1000; i++) {
+    script += snippet;
+  }
+  return script;
+}
+
+int main() {
+  std::string script = representativeScript();
+
+  size_t tokens = 0;
+  size_t literalBytes = 0;
+  size_t pooledBytes = 0;
+  size_t reservedBytes = 0;
+  size_t before = allocations;
+  {
+    Lexer lexer(script);
+    Token tok{};
+    while ((tok = lexer.nextToken()).type != token_type::eof) {
+      if (tok.type == token_type::identifier ||
+          tok.type == token_type::integer) {
+        literalBytes += tok.literal.size();
+      }
+      tokens++;
+    }
+    pooledBytes = lexer.pool()->bytes();
+    reservedBytes = lexer.pool()->capacity();
+  }
+  size_t lexerAllocations = allocations - before;
+
+  before = allocations;
+  {
+    Lexer lexer(script);
+    Parser parser(std::move(lexer));
+    Program program = parser.parseProgram();
+  }
+  size_t parserAllocations = allocations - before;
+
+  double lexerPerToken = static_cast<double>(lexerAllocations) / tokens;
+  double parserPerToken = static_cast<double>(parserAllocations) / tokens;
+
+  std::cout << "tokens:                     " << tokens << '\n';
+  std::cout << "lexer allocations/token:    " << lexerPerToken << '\n';
+  std::cout << "parser allocations/token:   " << parserPerToken << '\n';
+  std::cout << "literal bytes lexed/pooled: " << literalBytes << " / "
+            << pooledBytes << '\n';
+  std::cout << "literal bytes reserved:     " << reservedBytes << '\n';
+
+  bool regressed = false;
+  if (lexerPerToken > maxLexerAllocationsPerToken) {
+    std::cout << "lexer allocations regressed, pinned at "
+              << maxLexerAllocationsPerToken << '\n';
+    regressed = true;
+  }
+  if (parserPerToken > maxParserAllocationsPerToken) {
+    std::cout << "parser allocations regressed, pinned at "
+              << maxParserAllocationsPerToken << '\n';
+    regressed = true;
+  }
+  return regressed ? 1 : 0;
+}
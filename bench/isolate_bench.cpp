@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "column_kernel.h"
+#include "isolate.h"
+#include "lexer.h"
+#include "parser.h"
+
+// Jobs/sec for many small kernel runs spread over 1..N isolates, all
+// sharing one compiled kernel. Fails if any pooled run differs from a
+// direct one.
+static const size_t jobs = 4096;
+static const size_t rows = 1024;
+
+int main() {
+  std::vector<std::string_view> names{"x", "y"};
+  Lexer lexer("if (x < y) { x * 3 - y } else { y / (x + 1) }");
+  Parser parser(std::move(lexer));
+  auto expression = parser.parseExpression(precedence::LOWEST);
+  auto kernel = std::make_shared<const ColumnKernel>(*expression, names);
+
+  std::vector<int64_t> x(rows);
+  std::vector<int64_t> y(rows);
+  for (size_t i = 0; i < rows; i++) {
+    x[i] = static_cast<int64_t>((i * 7919) % 1000);
+    y[i] = static_cast<int64_t>((i * 104729) % 1000);
+  }
+
+  std::vector<int64_t> expected(rows);
+  kernel->run(std::vector<std::span<const int64_t>>{x, y}, expected);
+
+  std::vector<std::vector<int64_t>> outputs(jobs, std::vector<int64_t>(rows));
+  size_t maxThreads = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+
+  bool mismatch = false;
+  for (size_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+    std::vector<std::future<bool>> results{};
+    results.reserve(jobs);
+
+    auto start = std::chrono::steady_clock::now();
+    {
+      IsolatePool pool(threads);
+      for (size_t job = 0; job < jobs; job++) {
+        results.push_back(pool.submit(kernel, {x, y}, outputs[job]));
+      }
+      for (auto &result : results) {
+        result.wait();
+      }
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    for (const auto &output : outputs) {
+      mismatch |= output != expected;
+    }
+
+    std::cout << "isolates: " << threads << "  jobs/sec: " << jobs / seconds
+              << "  rows/sec: " << jobs * rows / seconds << '\n';
+
+    if (threads == maxThreads) {
+      break;
+    }
+  }
+
+  if (mismatch) {
+    std::cout << "pooled output differs from a direct run\n";
+    return 1;
+  }
+  return 0;
+}
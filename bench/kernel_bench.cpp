@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "column_kernel.h"
+#include "lexer.h"
+#include "parser.h"
+#include "profiler.h"
+#include "scheduler.h"
+
+// Rows per second for a compiled column kernel against interpreting the
+// expression once per row, and what suspending after every batch and
+// profiling cost. Fails if any of them disagree.
+static const size_t rows = size_t{1} << 22;
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+int main() {
+  std::vector<std::string> expressions{
+      "x * 2 + y > 10",
+      "if (x < y) { x * 3 - y } else { y / (x + 1) }",
+  };
+  std::vector<std::string_view> names{"x", "y"};
+
+  std::vector<int64_t> x(rows);
+  std::vector<int64_t> y(rows);
+  uint64_t state = 42;
+  for (size_t i = 0; i < rows; i++) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    x[i] = static_cast<int64_t>((state >> 33) % 1000);
+    y[i] = static_cast<int64_t>((state >> 13) % 1000);
+  }
+  std::vector<std::span<const int64_t>> columns{x, y};
+
+  bool mismatch = false;
+  for (const auto &input : expressions) {
+    Lexer lexer(input);
+    Parser parser(std::move(lexer));
+    auto expression = parser.parseExpression(precedence::LOWEST);
+
+    auto shared = std::make_shared<const ColumnKernel>(*expression, names);
+    const ColumnKernel &kernel = *shared;
+    if (!kernel.m_errors.empty()) {
+      std::cout << input << ": " << kernel.m_errors[0] << '\n';
+      return 1;
+    }
+
+    std::vector<int64_t> batched(rows);
+    auto start = std::chrono::steady_clock::now();
+    kernel.run(columns, batched);
+    double batchedSeconds = seconds(start);
+
+    std::vector<int64_t> sliced(rows);
+    start = std::chrono::steady_clock::now();
+    KernelTask task = runKernelTask(shared, columns, sliced, 1);
+    while (task.resume() == task_running) {
+    }
+    double slicedSeconds = seconds(start);
+
+    std::vector<int64_t> profiled(rows);
+    KernelProfile profile{};
+    KernelScratch scratch{};
+    scratch.profile = &profile;
+    start = std::chrono::steady_clock::now();
+    kernel.run(columns, profiled, scratch);
+    double profiledSeconds = seconds(start);
+
+    std::vector<int64_t> perRow(rows);
+    bool divisionByZero = false;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rows; i++) {
+      int64_t row[] = {x[i], y[i]};
+      perRow[i] = evaluateRow(*expression, names, row, divisionByZero);
+    }
+    double perRowSeconds = seconds(start);
+
+    mismatch |= batched != perRow || sliced != batched ||
+                profiled != batched;
+
+    std::cout << input << '\n';
+    std::cout << "  kernel rows/sec:  " << rows / batchedSeconds << '\n';
+    std::cout << "  per-row rows/sec: " << rows / perRowSeconds << '\n';
+    std::cout << "  speedup:          " << perRowSeconds / batchedSeconds
+              << "x\n";
+    std::cout << "  sliced rows/sec:  " << rows / slicedSeconds << '\n';
+    std::cout << "  profiled rows/sec: " << rows / profiledSeconds << '\n';
+    std::cout << collapsedStacks(kernel, profile, input);
+  }
+
+  if (mismatch) {
+    std::cout << "kernel output differs between runs\n";
+    return 1;
+  }
+  return 0;
+}
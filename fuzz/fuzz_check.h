@@ -0,0 +1,16 @@
+#ifndef FUZZ_CHECK_H
+#define FUZZ_CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// Unlike assert this survives NDEBUG, so release fuzz builds still crash on
+// a broken invariant.
+inline void fuzzCheck(bool condition, const char *message) {
+  if (!condition) {
+    std::fprintf(stderr, "fuzz check failed: %s\n", message);
+    std::abort();
+  }
+}
+
+#endif // FUZZ_CHECK_H
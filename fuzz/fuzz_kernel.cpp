@@ -0,0 +1,72 @@
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "column_kernel.h"
+#include "fuzz_check.h"
+#include "lexer.h"
+#include "parser.h"
+
+// differential: the batched, selection vector kernel has to agree with the
+// row at a time reference on every row
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  std::string input(reinterpret_cast<const char *>(data), size);
+
+  Lexer lexer(input);
+  Parser parser(std::move(lexer));
+  auto expression = parser.parseExpression(precedence::LOWEST);
+  if (!expression || !parser.m_errors.empty()) {
+    return 0;
+  }
+
+  std::vector<std::string_view> names{"x", "y", "z"};
+  ColumnKernel kernel(*expression, names);
+  if (!kernel.m_errors.empty()) {
+    return 0;
+  }
+
+  const int64_t interesting[] = {0,
+                                 1,
+                                 -1,
+                                 2,
+                                 7,
+                                 -13,
+                                 std::numeric_limits<int64_t>::min(),
+                                 std::numeric_limits<int64_t>::max()};
+
+  // more than two batches, values derived from the input so they vary
+  const size_t rows = ColumnKernel::batchSize * 2 + 17;
+  uint64_t state = 0x9e3779b97f4a7c15ull ^ size;
+  for (uint8_t byte : input) {
+    state = state * 6364136223846793005ull + byte;
+  }
+
+  std::vector<std::vector<int64_t>> values(names.size());
+  for (auto &column : values) {
+    for (size_t row = 0; row < rows; row++) {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      uint64_t bits = state >> 33;
+      column.push_back(bits % 4 == 0 ? interesting[bits % 8]
+                                     : static_cast<int64_t>(bits % 201) - 100);
+    }
+  }
+
+  std::vector<std::span<const int64_t>> columns(values.begin(), values.end());
+  std::vector<int64_t> output(rows);
+  bool clean = kernel.run(columns, output);
+
+  bool divisionByZero = false;
+  for (size_t row = 0; row < rows; row++) {
+    int64_t rowValues[] = {values[0][row], values[1][row], values[2][row]};
+    int64_t expected =
+        evaluateRow(*expression, names, rowValues, divisionByZero);
+    fuzzCheck(output[row] == expected, "kernel row differs from reference");
+  }
+  fuzzCheck(clean == !divisionByZero,
+            "kernel division by zero differs from reference");
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "fuzz_check.h"
+#include "lexer.h"
+#include "source.h"
+#include "token.h"
+
+// line/column the slow way, to check LineIndex against
+static SourceLocation naiveLocation(const std::string &input,
+                                    uint32_t offset) {
+  SourceLocation loc{1, 1};
+  for (uint32_t i = 0; i < offset; i++) {
+    if (input[i] == '\n') {
+      loc.line++;
+      loc.column = 1;
+    } else {
+      loc.column++;
+    }
+  }
+  return loc;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  std::string input(reinterpret_cast<const char *>(data), size);
+
+  // differential: the vectorized newline scan must match the scalar one
+  fuzzCheck(scanLineStarts(input) == scanLineStartsScalar(input),
+            "vectorized line scan differs from scalar scan");
+
+  Lexer lexer(input);
+  uint32_t previousOffset = 0;
+
+  // every token consumes at least one byte, so eof comes within size + 1
+  for (size_t count = 0;; count++) {
+    fuzzCheck(count <= size + 1, "lexer did not reach eof");
+
+    Token tok = lexer.nextToken();
+    if (tok.type == token_type::eof) {
+      break;
+    }
+
+    fuzzCheck(tok.offset >= previousOffset, "token offsets went backwards");
+    fuzzCheck(tok.offset < size, "token offset is past the input");
+
+    // a string's literal is the text between its quotes, and may be empty
+    size_t start = tok.offset;
+    if (tok.type == token_type::string_T) {
+      start++;
+      fuzzCheck(input[tok.offset] == '"' &&
+                    start + tok.literal.size() < size &&
+                    input[start + tok.literal.size()] == '"',
+                "string token is not quoted");
+    } else {
+      fuzzCheck(!tok.literal.empty(), "non eof token has an empty literal");
+    }
+    fuzzCheck(start + tok.literal.size() <= size,
+              "token literal runs past the input");
+    fuzzCheck(input.compare(start, tok.literal.size(), tok.literal) == 0,
+              "token literal does not match the input at its offset");
+
+    SourceLocation loc = lexer.location(tok.offset);
+    SourceLocation expected = naiveLocation(input, tok.offset);
+    fuzzCheck(loc.line == expected.line && loc.column == expected.column,
+              "line index disagrees with a naive scan");
+
+    previousOffset = tok.offset;
+  }
+  return 0;
+}
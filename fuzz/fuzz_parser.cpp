@@ -0,0 +1,26 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ast.h"
+#include "compile.h"
+#include "fuzz_check.h"
+#include "lexer.h"
+#include "parser.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  std::string input(reinterpret_cast<const char *>(data), size);
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program = parser.parseProgram();
+
+  // differential: the constexpr checker has to see the same errors
+  fuzzCheck(syntaxError(input).has_value() == !parser.m_errors.empty(),
+            "syntax checker disagrees with the parser");
+
+  // walk everything the parser built
+  program.string();
+  program.TokenLiteral();
+  return 0;
+}
@@ -0,0 +1,41 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ast.h"
+#include "fuzz_check.h"
+#include "lexer.h"
+#include "parser.h"
+
+// Program::string() does not separate statements ("a;b;" prints as "ab"),
+// so the whole program can't be reparsed as one string. Each statement's
+// printed form has to reparse into a program that prints the same way.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  std::string input(reinterpret_cast<const char *>(data), size);
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program = parser.parseProgram();
+  if (!parser.m_errors.empty()) {
+    return 0;
+  }
+
+  std::string concatenated{};
+  for (const auto &statement : program.statements) {
+    std::string printed = statement->string();
+    concatenated += printed;
+
+    Lexer relexer(printed);
+    Parser reparser(relexer);
+    Program reparsed = reparser.parseProgram();
+
+    fuzzCheck(reparser.m_errors.empty(), "printed statement does not reparse");
+    fuzzCheck(reparsed.statements.size() <= 1,
+              "printed statement reparses as several statements");
+    fuzzCheck(reparsed.string() == printed,
+              "print -> reparse -> print is not stable");
+  }
+  fuzzCheck(program.string() == concatenated,
+            "program does not print as its statements");
+  return 0;
+}
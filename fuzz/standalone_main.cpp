@@ -0,0 +1,36 @@
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static void runOne(const std::string &input) {
+  LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(input.data()),
+                         input.size());
+}
+
+// Replays each file given on the command line, or stdin when there are none
+// (the way AFL drives a target).
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::string input{std::istreambuf_iterator<char>(std::cin),
+                      std::istreambuf_iterator<char>()};
+    runOne(input);
+    return 0;
+  }
+
+  for (int i = 1; i < argc; i++) {
+    std::ifstream file(argv[i], std::ios::binary);
+    if (!file) {
+      std::cerr << "could not open " << argv[i] << '\n';
+      return 1;
+    }
+    std::string input{std::istreambuf_iterator<char>(file),
+                      std::istreambuf_iterator<char>()};
+    runOne(input);
+  }
+  return 0;
+}
@@ -27,24 +27,22 @@ std::string Program::string() const {
 }
 
 // Identifier
-Identifier::Identifier(Token token, const std::string value)
-    : token(token), value(value){};
+Identifier::Identifier(Token token, std::string_view value)
+    : token(std::move(token)), value(value){};
 
 const void Identifier::expressionNode() const {}
 
-const std::string Identifier::TokenLiteral() const { return token.literal; }
-
-std::string Identifier::string() const {
-  std::stringstream SS;
-  SS << value;
-  return SS.str();
+const std::string Identifier::TokenLiteral() const {
+  return std::string(token.literal);
 }
 
+std::string Identifier::string() const { return std::string(value); }
+
 // Return Statement
 const void ReturnStatement::statementNode() const {}
 
 const std::string ReturnStatement::TokenLiteral() const {
-  return token.literal;
+  return std::string(token.literal);
 }
 
 std::string ReturnStatement::string() const {
@@ -57,6 +55,10 @@ std::string ReturnStatement::string() const {
   return SS.str();
 }
 
+bool ReturnStatement::isTailCall() const {
+  return dynamic_cast<const CallExpression *>(returnValue.get()) != nullptr;
+}
+
 // Let Statement
 LetStatement::LetStatement(std::unique_ptr<Identifier> name,
                            std::unique_ptr<Expression> value)
@@ -68,7 +70,9 @@ LetStatement::LetStatement(std::unique_ptr<Identifier> name,
 
 const void LetStatement::statementNode() const {}
 
-const std::string LetStatement::TokenLiteral() const { return token.literal; }
+const std::string LetStatement::TokenLiteral() const {
+  return std::string(token.literal);
+}
 
 std::string LetStatement::string() const {
   std::stringstream SS;
@@ -86,7 +90,7 @@ std::string LetStatement::string() const {
 const void ExpressionStatement::statementNode() const {}
 
 const std::string ExpressionStatement::TokenLiteral() const {
-  return token.literal;
+  return std::string(token.literal);
 }
 
 std::string ExpressionStatement::string() const {
@@ -98,11 +102,11 @@ std::string ExpressionStatement::string() const {
 }
 
 // Constructor implementation
-IntegerLiteral::IntegerLiteral(Token token, const int value)
-    : token(token), value(value) {}
+IntegerLiteral::IntegerLiteral(Token token, Integer value)
+    : token(std::move(token)), value(std::move(value)) {}
 
 // Implementation of virtual function string()
-std::string IntegerLiteral::string() const { return std::to_string(value); }
+std::string IntegerLiteral::string() const { return value.string(); }
 
 // Implementation of virtual function expressionNode()
 const void IntegerLiteral::expressionNode() const {
@@ -110,7 +114,177 @@ const void IntegerLiteral::expressionNode() const {
 }
 
 // Implementation of virtual function TokenLiteral()
-const std::string IntegerLiteral::TokenLiteral() const { return token.literal; }
+const std::string IntegerLiteral::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+// Prefix Expression
+PrefixExpression::PrefixExpression(Token token,
+                                   std::unique_ptr<Expression> right)
+    : token(std::move(token)), op(this->token.literal),
+      right(std::move(right)) {}
+
+const void PrefixExpression::expressionNode() const {}
+
+const std::string PrefixExpression::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string PrefixExpression::string() const {
+  std::stringstream SS;
+  SS << "(" << op;
+  if (right)
+    SS << right->string();
+  SS << ")";
+  return SS.str();
+}
+
+// Infix Expression
+InfixExpression::InfixExpression(Token token, std::unique_ptr<Expression> left,
+                                 std::unique_ptr<Expression> right)
+    : token(std::move(token)), left(std::move(left)),
+      op(this->token.literal), right(std::move(right)) {}
+
+const void InfixExpression::expressionNode() const {}
+
+const std::string InfixExpression::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string InfixExpression::string() const {
+  std::stringstream SS;
+  SS << "(";
+  if (left)
+    SS << left->string();
+  SS << " " << op << " ";
+  if (right)
+    SS << right->string();
+  SS << ")";
+  return SS.str();
+}
+
+// Boolean
+Boolean::Boolean(Token token, bool value)
+    : token(std::move(token)), value(value) {}
+
+const void Boolean::expressionNode() const {}
+
+const std::string Boolean::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string Boolean::string() const { return std::string(token.literal); }
+
+// Block Statement
+const void BlockStatement::statementNode() const {}
+
+const std::string BlockStatement::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string BlockStatement::string() const {
+  std::stringstream SS;
+  SS << "{ ";
+  // unlike Program, expression statements are terminated so a printed
+  // block reparses into the same statements
+  for (const auto &statement : statements) {
+    SS << statement->string();
+    if (dynamic_cast<const ExpressionStatement *>(statement.get()))
+      SS << ";";
+    SS << " ";
+  }
+  SS << "}";
+  return SS.str();
+}
+
+// If Expression
+const void IfExpression::expressionNode() const {}
+
+const std::string IfExpression::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string IfExpression::string() const {
+  std::stringstream SS;
+  SS << "if (";
+  if (condition)
+    SS << condition->string();
+  SS << ") " << consequence->string();
+  if (alternative)
+    SS << " else " << alternative->string();
+  return SS.str();
+}
+
+// Function Literal
+const void FunctionLiteral::expressionNode() const {}
+
+const std::string FunctionLiteral::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string FunctionLiteral::string() const {
+  std::stringstream SS;
+  SS << TokenLiteral() << "(";
+  for (size_t i = 0; i < parameters.size(); i++) {
+    if (i > 0)
+      SS << ", ";
+    SS << parameters[i]->string();
+  }
+  SS << ") " << body->string();
+  return SS.str();
+}
+
+// String Literal
+StringLiteral::StringLiteral(Token token, std::string_view value)
+    : token(std::move(token)), value(value) {}
+
+const void StringLiteral::expressionNode() const {}
+
+const std::string StringLiteral::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string StringLiteral::string() const {
+  return "\"" + std::string(value) + "\"";
+}
+
+// Import Expression
+const void ImportExpression::expressionNode() const {}
+
+const std::string ImportExpression::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string ImportExpression::string() const {
+  return "import(\"" + std::string(path) + "\")";
+}
+
+// Call Expression
+CallExpression::CallExpression(Token token,
+                               std::unique_ptr<Expression> function)
+    : token(std::move(token)), function(std::move(function)) {}
+
+const void CallExpression::expressionNode() const {}
+
+const std::string CallExpression::TokenLiteral() const {
+  return std::string(token.literal);
+}
+
+std::string CallExpression::string() const {
+  std::stringstream SS;
+  if (function)
+    SS << function->string();
+  SS << "(";
+  for (size_t i = 0; i < arguments.size(); i++) {
+    if (i > 0)
+      SS << ", ";
+    // TODO: remove nill checks when every prefix has a parse function
+    if (arguments[i])
+      SS << arguments[i]->string();
+  }
+  SS << ")";
+  return SS.str();
+}
 
 void testString() {
   std::vector<std::unique_ptr<Statement>> statements{};
@@ -1,9 +1,12 @@
 #ifndef AST_H
 #define AST_H
 
+#include "integer.h"
+#include "literal_pool.h"
 #include "token.h"
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Node {
@@ -32,15 +35,17 @@ public:
   std::string string() const override;
   const std::string TokenLiteral() const override;
   std::vector<std::unique_ptr<Statement>> statements{};
+  // keeps the identifier and literal text the statements point at alive
+  std::shared_ptr<const LiteralPool> pool{};
 };
 
 class Identifier : public Expression {
 public:
   Identifier(){};
-  Identifier(Token token, const std::string value);
+  Identifier(Token token, std::string_view value);
 
   Token token{};
-  std::string value{};
+  std::string_view value{};
 
   std::string string() const override;
   const void expressionNode() const;
@@ -68,6 +73,9 @@ public:
   std::string string() const override;
   const void statementNode() const;
   const std::string TokenLiteral() const override;
+  // `return f(...)`: nothing is left to do in the caller once the call
+  // returns, so its frame can be reused for the callee
+  bool isTailCall() const;
 };
 
 class ExpressionStatement : public Statement {
@@ -82,11 +90,135 @@ public:
 class IntegerLiteral : public Expression {
 public:
   IntegerLiteral() = default;
-  IntegerLiteral(Token token, const int value);
+  IntegerLiteral(Token token, Integer value);
   virtual ~IntegerLiteral() = default;
 
   Token token{};
-  int value;
+  Integer value{};
+
+  std::string string() const override;
+  const void expressionNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+class PrefixExpression : public Expression {
+public:
+  PrefixExpression() = default;
+  PrefixExpression(Token token, std::unique_ptr<Expression> right);
+
+  // the operator token, '!' or '-'
+  Token token{};
+  std::string_view op{};
+  std::unique_ptr<Expression> right{};
+
+  std::string string() const override;
+  const void expressionNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+class InfixExpression : public Expression {
+public:
+  InfixExpression() = default;
+  InfixExpression(Token token, std::unique_ptr<Expression> left,
+                  std::unique_ptr<Expression> right);
+
+  // the operator token
+  Token token{};
+  std::unique_ptr<Expression> left{};
+  std::string_view op{};
+  std::unique_ptr<Expression> right{};
+
+  std::string string() const override;
+  const void expressionNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+class Boolean : public Expression {
+public:
+  Boolean() = default;
+  Boolean(Token token, bool value);
+
+  Token token{};
+  bool value{false};
+
+  std::string string() const override;
+  const void expressionNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+class BlockStatement : public Statement {
+public:
+  // the '{' token
+  Token token{};
+  std::vector<std::unique_ptr<Statement>> statements{};
+
+  std::string string() const override;
+  const void statementNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+class IfExpression : public Expression {
+public:
+  Token token{};
+  std::unique_ptr<Expression> condition{};
+  std::unique_ptr<BlockStatement> consequence{};
+  // null when there is no else branch
+  std::unique_ptr<BlockStatement> alternative{};
+
+  std::string string() const override;
+  const void expressionNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+class FunctionLiteral : public Expression {
+public:
+  // the 'fn' token
+  Token token{};
+  std::vector<std::unique_ptr<Identifier>> parameters{};
+  std::unique_ptr<BlockStatement> body{};
+
+  std::string string() const override;
+  const void expressionNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+class StringLiteral : public Expression {
+public:
+  StringLiteral() = default;
+  StringLiteral(Token token, std::string_view value);
+
+  Token token{};
+  // the text between the quotes
+  std::string_view value{};
+
+  std::string string() const override;
+  const void expressionNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+// import("path"), evaluates to the module at path, resolved relative to
+// the importing module by ModuleLoader
+class ImportExpression : public Expression {
+public:
+  // the 'import' token
+  Token token{};
+  std::string_view path{};
+
+  std::string string() const override;
+  const void expressionNode() const;
+  const std::string TokenLiteral() const override;
+};
+
+class CallExpression : public Expression {
+public:
+  CallExpression() = default;
+  CallExpression(Token token, std::unique_ptr<Expression> function);
+
+  // the '(' token
+  Token token{};
+  // identifier or function literal being called
+  std::unique_ptr<Expression> function{};
+  std::vector<std::unique_ptr<Expression>> arguments{};
 
   std::string string() const override;
   const void expressionNode() const;
@@ -0,0 +1,682 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ast.h"
+#include "column_kernel.h"
+#include "lexer.h"
+#include "parser.h"
+
+// Row operations shared by the kernel loops and the row reference. Signed
+// overflow is undefined in C++, so arithmetic goes through uint64_t and
+// wraps.
+static int64_t addRow(int64_t a, int64_t b) {
+  return static_cast<int64_t>(static_cast<uint64_t>(a) +
+                              static_cast<uint64_t>(b));
+}
+
+static int64_t subtractRow(int64_t a, int64_t b) {
+  return static_cast<int64_t>(static_cast<uint64_t>(a) -
+                              static_cast<uint64_t>(b));
+}
+
+static int64_t multiplyRow(int64_t a, int64_t b) {
+  return static_cast<int64_t>(static_cast<uint64_t>(a) *
+                              static_cast<uint64_t>(b));
+}
+
+static int64_t negateRow(int64_t a) {
+  return static_cast<int64_t>(0 - static_cast<uint64_t>(a));
+}
+
+static int64_t divideRow(int64_t a, int64_t b, bool &divisionByZero) {
+  if (b == 0) {
+    divisionByZero = true;
+    return 0;
+  }
+  // INT64_MIN / -1 overflows, wrap it like the other operators
+  if (b == -1) {
+    return negateRow(a);
+  }
+  return a / b;
+}
+
+// Dense when selection is null (count rows from the start of the batch),
+// otherwise only the selected rows. The dense loops are plain enough for
+// the compiler to vectorize.
+template <typename Operand, typename Fn>
+static void applyBinary(int64_t *__restrict out, const int64_t *__restrict a,
+                        Operand b, const uint32_t *selection, size_t count,
+                        Fn fn) {
+  if (selection == nullptr) {
+    for (size_t i = 0; i < count; i++) {
+      out[i] = fn(a[i], b[i]);
+    }
+    return;
+  }
+  for (size_t k = 0; k < count; k++) {
+    uint32_t row = selection[k];
+    out[row] = fn(a[row], b[row]);
+  }
+}
+
+template <typename Fn>
+static void applyUnary(int64_t *__restrict out, const int64_t *__restrict a,
+                       const uint32_t *selection, size_t count, Fn fn) {
+  if (selection == nullptr) {
+    for (size_t i = 0; i < count; i++) {
+      out[i] = fn(a[i]);
+    }
+    return;
+  }
+  for (size_t k = 0; k < count; k++) {
+    uint32_t row = selection[k];
+    out[row] = fn(a[row]);
+  }
+}
+
+// Stands in for an operand column when the operand is a literal folded
+// into its operator node.
+struct Broadcast {
+  int64_t value;
+  int64_t operator[](size_t) const { return value; }
+};
+
+template <typename Operand>
+static void applyOperator(kernel_op op, int64_t *__restrict out,
+                          const int64_t *__restrict a, Operand b,
+                          const uint32_t *selection, size_t count,
+                          bool &divisionByZero) {
+  switch (op) {
+  case op_add:
+    applyBinary(out, a, b, selection, count, addRow);
+    break;
+  case op_subtract:
+    applyBinary(out, a, b, selection, count, subtractRow);
+    break;
+  case op_multiply:
+    applyBinary(out, a, b, selection, count, multiplyRow);
+    break;
+  case op_divide: {
+    bool divided = false;
+    applyBinary(out, a, b, selection, count,
+                [&divided](int64_t x, int64_t y) {
+                  return divideRow(x, y, divided);
+                });
+    divisionByZero |= divided;
+    break;
+  }
+  case op_less:
+    applyBinary(out, a, b, selection, count,
+                [](int64_t x, int64_t y) -> int64_t { return x < y; });
+    break;
+  case op_greater:
+    applyBinary(out, a, b, selection, count,
+                [](int64_t x, int64_t y) -> int64_t { return x > y; });
+    break;
+  case op_equal:
+    applyBinary(out, a, b, selection, count,
+                [](int64_t x, int64_t y) -> int64_t { return x == y; });
+    break;
+  case op_not_equal:
+    applyBinary(out, a, b, selection, count,
+                [](int64_t x, int64_t y) -> int64_t { return x != y; });
+    break;
+  default:
+    break;
+  }
+}
+
+static kernel_op infixOp(std::string_view op) {
+  if (op == "-") {
+    return op_subtract;
+  } else if (op == "*") {
+    return op_multiply;
+  } else if (op == "/") {
+    return op_divide;
+  } else if (op == "<") {
+    return op_less;
+  } else if (op == ">") {
+    return op_greater;
+  } else if (op == "==") {
+    return op_equal;
+  } else if (op == "!=") {
+    return op_not_equal;
+  }
+  return op_add;
+}
+
+static const IntegerLiteral *smallLiteral(const Expression *expression) {
+  auto *literal = dynamic_cast<const IntegerLiteral *>(expression);
+  return literal && literal->value.isSmall() ? literal : nullptr;
+}
+
+ColumnKernel::ColumnKernel(const Expression &expression,
+                           const std::vector<std::string_view> &columns)
+    : m_columns(columns.begin(), columns.end()) {
+  m_root = compile(&expression);
+}
+
+int ColumnKernel::addNode(KernelNode node) {
+  m_nodes.push_back(node);
+  return static_cast<int>(m_nodes.size() - 1);
+}
+
+int ColumnKernel::compileBlock(const BlockStatement *block) {
+  const ExpressionStatement *statement = nullptr;
+  if (block && block->statements.size() == 1) {
+    statement =
+        dynamic_cast<const ExpressionStatement *>(block->statements[0].get());
+  }
+  if (!statement) {
+    m_errors.push_back("kernel blocks must hold a single expression.");
+    return -1;
+  }
+  return compile(statement->expression.get());
+}
+
+int ColumnKernel::compile(const Expression *expression) {
+  if (!expression) {
+    m_errors.push_back("kernel expression is missing an operand.");
+    return -1;
+  }
+
+  if (auto *identifier = dynamic_cast<const Identifier *>(expression)) {
+    for (size_t i = 0; i < m_columns.size(); i++) {
+      if (m_columns[i] == identifier->value) {
+        return addNode({op_column, false, static_cast<int64_t>(i), -1, -1, -1,
+                        identifier->token.offset});
+      }
+    }
+    m_errors.push_back("unknown column " + identifier->string() + ".");
+    return -1;
+  }
+
+  if (auto *literal = dynamic_cast<const IntegerLiteral *>(expression)) {
+    if (!literal->value.isSmall()) {
+      m_errors.push_back(literal->string() + " does not fit in a column.");
+      return -1;
+    }
+    return addNode({op_constant, false, literal->value.small(), -1, -1, -1,
+                    literal->token.offset});
+  }
+
+  if (auto *boolean = dynamic_cast<const Boolean *>(expression)) {
+    return addNode({op_constant, true, boolean->value ? 1 : 0, -1, -1, -1,
+                    boolean->token.offset});
+  }
+
+  if (auto *prefix = dynamic_cast<const PrefixExpression *>(expression)) {
+    int right = compile(prefix->right.get());
+    if (right < 0) {
+      return -1;
+    }
+    bool isBoolean = m_nodes[right].isBoolean;
+    if (prefix->op == "-") {
+      if (isBoolean) {
+        m_errors.push_back("unknown operator: -BOOLEAN.");
+        return -1;
+      }
+      return addNode({op_negate, false, 0, right, -1, -1, prefix->token.offset});
+    }
+    return addNode({op_not, true, 0, right, -1, -1, prefix->token.offset});
+  }
+
+  if (auto *infix = dynamic_cast<const InfixExpression *>(expression)) {
+    kernel_op op = infixOp(infix->op);
+
+    // An integer literal operand is folded into the operator node, which
+    // saves evaluating a constant node and reading its filled batch. Folding
+    // a left literal swaps the operands, so only operators that can mirror.
+    const IntegerLiteral *literal = smallLiteral(infix->right.get());
+    const Expression *operand = infix->left.get();
+    if (!literal && op != op_subtract && op != op_divide) {
+      literal = smallLiteral(infix->left.get());
+      operand = infix->right.get();
+      if (literal && op == op_less) {
+        op = op_greater;
+      } else if (literal && op == op_greater) {
+        op = op_less;
+      }
+    }
+
+    int left = compile(literal ? operand : infix->left.get());
+    int right = literal ? -1 : compile(infix->right.get());
+    if (left < 0 || (!literal && right < 0)) {
+      return -1;
+    }
+
+    bool leftBoolean = m_nodes[left].isBoolean;
+    bool rightBoolean = !literal && m_nodes[right].isBoolean;
+    if (op == op_equal || op == op_not_equal) {
+      if (leftBoolean != rightBoolean) {
+        m_errors.push_back("type mismatch in " + infix->string() + ".");
+        return -1;
+      }
+    } else if (leftBoolean || rightBoolean) {
+      m_errors.push_back("operator " + std::string(infix->op) +
+                         " needs integer operands.");
+      return -1;
+    }
+
+    bool isBoolean = op == op_less || op == op_greater || op == op_equal ||
+                     op == op_not_equal;
+    int64_t value = literal ? literal->value.small() : 0;
+    return addNode({op, isBoolean, value, left, right, -1, infix->token.offset,
+                    literal != nullptr});
+  }
+
+  if (auto *ifExpression = dynamic_cast<const IfExpression *>(expression)) {
+    int condition = compile(ifExpression->condition.get());
+    int consequence = compileBlock(ifExpression->consequence.get());
+    if (!ifExpression->alternative) {
+      m_errors.push_back("if without else has no value for skipped rows.");
+      return -1;
+    }
+    int alternative = compileBlock(ifExpression->alternative.get());
+    if (condition < 0 || consequence < 0 || alternative < 0) {
+      return -1;
+    }
+
+    bool isBoolean = m_nodes[consequence].isBoolean;
+    if (isBoolean != m_nodes[alternative].isBoolean) {
+      m_errors.push_back("if branches have different types.");
+      return -1;
+    }
+    return addNode({op_select, isBoolean, 0, consequence, alternative,
+                    condition, ifExpression->token.offset});
+  }
+
+  m_errors.push_back("unsupported expression in a kernel: " +
+                     expression->string() + ".");
+  return -1;
+}
+
+uint64_t KernelProfile::selfNanos(const std::vector<KernelNode> &kernelNodes,
+                                  size_t node) const {
+  const KernelNode &kernelNode = kernelNodes[node];
+  uint64_t self = nodes[node].totalNanos;
+  for (int operand : {kernelNode.lhs, kernelNode.rhs, kernelNode.condition}) {
+    if (operand >= 0) {
+      self -= std::min(self, nodes[operand].totalNanos);
+    }
+  }
+  return self;
+}
+
+const int64_t *ColumnKernel::evaluate(int index, KernelScratch &scratch,
+                                      const uint32_t *selection,
+                                      size_t count) const {
+  if (!scratch.sampling) {
+    return evaluateNode(index, scratch, selection, count);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  const int64_t *out = evaluateNode(index, scratch, selection, count);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  KernelNodeProfile &profile = scratch.profile->nodes[index];
+  profile.calls++;
+  profile.rows += count;
+  profile.totalNanos += static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  return out;
+}
+
+const int64_t *ColumnKernel::evaluateNode(int index, KernelScratch &scratch,
+                                          const uint32_t *selection,
+                                          size_t count) const {
+  const KernelNode &node = m_nodes[index];
+  int64_t *out = scratch.values[index].data();
+
+  switch (node.op) {
+  case op_column:
+    return scratch.columns[node.value].data() + scratch.start;
+  case op_constant:
+    // filled once per run
+    return out;
+  case op_negate:
+    applyUnary(out, evaluate(node.lhs, scratch, selection, count), selection,
+               count, negateRow);
+    return out;
+  case op_not: {
+    const int64_t *right = evaluate(node.lhs, scratch, selection, count);
+    // integers are always truthy, so !<integer> is false
+    if (m_nodes[node.lhs].isBoolean) {
+      applyUnary(out, right, selection, count,
+                 [](int64_t a) -> int64_t { return a == 0; });
+    } else {
+      applyUnary(out, right, selection, count,
+                 [](int64_t) -> int64_t { return 0; });
+    }
+    return out;
+  }
+  case op_select: {
+    const int64_t *condition =
+        evaluate(node.condition, scratch, selection, count);
+    // as with !, an integer condition is always truthy
+    bool truthy = !m_nodes[node.condition].isBoolean;
+    std::vector<uint32_t> &taken = scratch.taken[index];
+    std::vector<uint32_t> &skipped = scratch.skipped[index];
+    size_t takenCount = 0;
+    size_t skippedCount = 0;
+    for (size_t k = 0; k < count; k++) {
+      uint32_t row = selection ? selection[k] : static_cast<uint32_t>(k);
+      if (truthy || condition[row] != 0) {
+        taken[takenCount++] = row;
+      } else {
+        skipped[skippedCount++] = row;
+      }
+    }
+
+    if (takenCount > 0) {
+      const int64_t *consequence =
+          evaluate(node.lhs, scratch, taken.data(), takenCount);
+      for (size_t k = 0; k < takenCount; k++) {
+        out[taken[k]] = consequence[taken[k]];
+      }
+    }
+    if (skippedCount > 0) {
+      const int64_t *alternative =
+          evaluate(node.rhs, scratch, skipped.data(), skippedCount);
+      for (size_t k = 0; k < skippedCount; k++) {
+        out[skipped[k]] = alternative[skipped[k]];
+      }
+    }
+    return out;
+  }
+  default:
+    break;
+  }
+
+  const int64_t *a = evaluate(node.lhs, scratch, selection, count);
+  if (node.literalOperand) {
+    applyOperator(node.op, out, a, Broadcast{node.value}, selection, count,
+                  scratch.divisionByZero);
+  } else {
+    applyOperator(node.op, out, a,
+                  evaluate(node.rhs, scratch, selection, count), selection,
+                  count, scratch.divisionByZero);
+  }
+  return out;
+}
+
+bool ColumnKernel::run(std::span<const std::span<const int64_t>> columns,
+                       std::span<int64_t> output) const {
+  KernelScratch scratch{};
+  return run(columns, output, scratch);
+}
+
+bool ColumnKernel::run(std::span<const std::span<const int64_t>> columns,
+                       std::span<int64_t> output,
+                       KernelScratch &scratch) const {
+  if (!prepare(columns, output.size(), scratch)) {
+    return false;
+  }
+  for (size_t start = 0; start < output.size(); start += batchSize) {
+    runBatch(output, start, scratch);
+  }
+  return !scratch.divisionByZero;
+}
+
+bool ColumnKernel::prepare(std::span<const std::span<const int64_t>> columns,
+                           size_t rows, KernelScratch &scratch) const {
+  assert(m_errors.empty() && "running a kernel that failed to compile");
+  if (!m_errors.empty() || m_root < 0) {
+    return false;
+  }
+  // batches read every column at the output's rows
+  if (columns.size() != m_columns.size()) {
+    return false;
+  }
+  for (const auto &column : columns) {
+    if (column.size() != rows) {
+      return false;
+    }
+  }
+
+  // buffers left over from earlier runs keep their capacity
+  scratch.columns = columns;
+  scratch.start = 0;
+  scratch.divisionByZero = false;
+  scratch.values.resize(m_nodes.size());
+  scratch.taken.resize(m_nodes.size());
+  scratch.skipped.resize(m_nodes.size());
+  scratch.sampling = false;
+  if (scratch.profile) {
+    scratch.profile->nodes.resize(m_nodes.size());
+  }
+  for (size_t i = 0; i < m_nodes.size(); i++) {
+    switch (m_nodes[i].op) {
+    case op_column:
+      break;
+    case op_constant:
+      scratch.values[i].assign(batchSize, m_nodes[i].value);
+      break;
+    case op_select:
+      scratch.taken[i].resize(batchSize);
+      scratch.skipped[i].resize(batchSize);
+      scratch.values[i].resize(batchSize);
+      break;
+    default:
+      scratch.values[i].resize(batchSize);
+      break;
+    }
+  }
+  return true;
+}
+
+void ColumnKernel::runBatch(std::span<int64_t> output, size_t start,
+                            KernelScratch &scratch) const {
+  size_t count = std::min(batchSize, output.size() - start);
+  scratch.start = start;
+  if (scratch.profile) {
+    KernelProfile &profile = *scratch.profile;
+    scratch.sampling =
+        profile.sampleEvery > 0 && profile.batches % profile.sampleEvery == 0;
+    profile.batches++;
+  }
+  const int64_t *result = evaluate(m_root, scratch, nullptr, count);
+  std::copy(result, result + count, output.begin() + start);
+}
+
+bool ColumnKernel::isBoolean() const {
+  return m_root >= 0 && m_nodes[m_root].isBoolean;
+}
+
+const std::vector<KernelNode> &ColumnKernel::nodes() const { return m_nodes; }
+
+const std::vector<std::string> &ColumnKernel::columns() const {
+  return m_columns;
+}
+
+int ColumnKernel::root() const { return m_root; }
+
+// isBoolean is only needed for `!`, which is false for any integer
+static int64_t rowValue(const Expression *expression,
+                        const std::vector<std::string_view> &columns,
+                        std::span<const int64_t> row, bool &divisionByZero,
+                        bool &isBoolean) {
+  isBoolean = false;
+
+  if (auto *identifier = dynamic_cast<const Identifier *>(expression)) {
+    auto column = std::find(columns.begin(), columns.end(), identifier->value);
+    return row[column - columns.begin()];
+  }
+
+  if (auto *literal = dynamic_cast<const IntegerLiteral *>(expression)) {
+    return literal->value.small();
+  }
+
+  if (auto *boolean = dynamic_cast<const Boolean *>(expression)) {
+    isBoolean = true;
+    return boolean->value ? 1 : 0;
+  }
+
+  if (auto *prefix = dynamic_cast<const PrefixExpression *>(expression)) {
+    bool rightBoolean = false;
+    int64_t right = rowValue(prefix->right.get(), columns, row,
+                             divisionByZero, rightBoolean);
+    if (prefix->op == "-") {
+      return negateRow(right);
+    }
+    isBoolean = true;
+    return rightBoolean ? right == 0 : 0;
+  }
+
+  if (auto *infix = dynamic_cast<const InfixExpression *>(expression)) {
+    bool unused = false;
+    int64_t left =
+        rowValue(infix->left.get(), columns, row, divisionByZero, unused);
+    int64_t right =
+        rowValue(infix->right.get(), columns, row, divisionByZero, unused);
+    std::string_view op = infix->op;
+    isBoolean = op == "<" || op == ">" || op == "==" || op == "!=";
+    if (op == "+")
+      return addRow(left, right);
+    if (op == "-")
+      return subtractRow(left, right);
+    if (op == "*")
+      return multiplyRow(left, right);
+    if (op == "/")
+      return divideRow(left, right, divisionByZero);
+    if (op == "<")
+      return left < right;
+    if (op == ">")
+      return left > right;
+    if (op == "==")
+      return left == right;
+    return left != right;
+  }
+
+  auto *ifExpression = dynamic_cast<const IfExpression *>(expression);
+  bool conditionBoolean = false;
+  int64_t condition = rowValue(ifExpression->condition.get(), columns, row,
+                               divisionByZero, conditionBoolean);
+  const BlockStatement *block = condition != 0 || !conditionBoolean
+                                    ? ifExpression->consequence.get()
+                                    : ifExpression->alternative.get();
+  auto *statement =
+      dynamic_cast<const ExpressionStatement *>(block->statements[0].get());
+  return rowValue(statement->expression.get(), columns, row, divisionByZero,
+                  isBoolean);
+}
+
+int64_t evaluateRow(const Expression &expression,
+                    const std::vector<std::string_view> &columns,
+                    std::span<const int64_t> row, bool &divisionByZero) {
+  bool isBoolean = false;
+  return rowValue(&expression, columns, row, divisionByZero, isBoolean);
+}
+
+void testColumnKernel() {
+  struct KernelTest {
+    std::string input;
+    bool isBoolean;
+  };
+
+  std::vector<KernelTest> tests{
+      {"x * 2 + y > 10", true},
+      {"if (x < y) { x - y } else { (y - x) * -3 }", false},
+      {"if (x > 0) { if (y > 0) { x / y } else { 7 } } else { -x }", false},
+      {"!(x == y) != false", true},
+      {"if (5) { x } else { y }", false},
+      {"x / y", false},
+      {"!(x / y) == (if (x / (y + 1)) { true } else { false })", true},
+      {"3 < x", true},
+      {"(0 == x) != (y == 0)", true},
+      {"10 - x * 2 + (1 / y) - 5 / 2", false},
+      {"if (2 > x) { x / 0 } else { 5 * y }", false},
+  };
+
+  std::vector<std::string_view> names{"x", "y"};
+
+  // crosses a batch boundary and covers the wrapping edges
+  std::vector<int64_t> x{};
+  std::vector<int64_t> y{};
+  for (int64_t i = 0; i < 3000; i++) {
+    x.push_back((i * 37) % 101 - 50);
+    y.push_back((i * 53) % 97 - 40);
+  }
+  x.push_back(INT64_MIN);
+  y.push_back(-1);
+
+  std::vector<std::span<const int64_t>> columns{x, y};
+
+  for (const auto &test : tests) {
+    Lexer lexer(test.input);
+    Parser parser(lexer);
+    auto expression = parser.parseExpression(precedence::LOWEST);
+    checkParserErrors(parser);
+
+    ColumnKernel kernel(*expression, names);
+    assert(kernel.m_errors.empty() && "kernel failed to compile");
+    assert(kernel.isBoolean() == test.isBoolean &&
+           "kernel result has the wrong type");
+
+    std::vector<int64_t> output(x.size());
+    [[maybe_unused]] bool clean = kernel.run(columns, output);
+
+    bool divisionByZero = false;
+    for (size_t row = 0; row < x.size(); row++) {
+      int64_t values[] = {x[row], y[row]};
+      [[maybe_unused]] int64_t expected =
+          evaluateRow(*expression, names, values, divisionByZero);
+      assert(output[row] == expected && "kernel row differs from reference");
+    }
+    assert(clean == !divisionByZero &&
+           "kernel division by zero differs from reference");
+  }
+
+  // literal operands fold into their operators: x, *2, y, +, >10
+  Lexer fusedLexer("x * 2 + y > 10");
+  Parser fusedParser(fusedLexer);
+  auto fusedExpression = fusedParser.parseExpression(precedence::LOWEST);
+  ColumnKernel fused(*fusedExpression, names);
+  assert(fused.nodes().size() == 5 && "literal operands were not folded");
+  assert(fused.nodes()[fused.root()].literalOperand &&
+         fused.nodes()[fused.root()].value == 10 &&
+         "comparison did not fold its literal");
+
+  // the kernel keeps its own column names, and rejects columns that
+  // don't match the output instead of reading past them
+  std::vector<int64_t> shape(x.size(), 7);
+  std::unique_ptr<ColumnKernel> owned{};
+  {
+    std::vector<std::string> temporary{"x", "y"};
+    Lexer lexer("x + y");
+    Parser parser(lexer);
+    auto expression = parser.parseExpression(precedence::LOWEST);
+    owned = std::make_unique<ColumnKernel>(
+        *expression,
+        std::vector<std::string_view>(temporary.begin(), temporary.end()));
+  }
+  assert(owned->columns()[1] == "y" && "kernel column names dangle");
+  std::vector<int64_t> shorter(x.begin(), x.end() - 1);
+  assert(!owned->run(std::vector<std::span<const int64_t>>{shorter, y},
+                     shape) &&
+         shape[0] == 7 && "short column was not rejected");
+  assert(!owned->run(std::vector<std::span<const int64_t>>{x}, shape) &&
+         "missing column was not rejected");
+  assert(owned->run(columns, shape) && shape[0] == x[0] + y[0] &&
+         "matching columns were rejected");
+
+  std::vector<std::string> failures{"z + 1", "x + true", "if (x > y) { x }",
+                                    "f(x)", "-(x < y)", "1 == (x < y)"};
+  for (const auto &input : failures) {
+    Lexer lexer(input);
+    Parser parser(lexer);
+    auto expression = parser.parseExpression(precedence::LOWEST);
+
+    ColumnKernel kernel(*expression, names);
+    assert(!kernel.m_errors.empty() && "invalid kernel compiled");
+  }
+}
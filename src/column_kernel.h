@@ -0,0 +1,146 @@
+#ifndef COLUMN_KERNEL_H
+#define COLUMN_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ast.h"
+
+enum kernel_op {
+  op_column,
+  op_constant,
+  op_add,
+  op_subtract,
+  op_multiply,
+  op_divide,
+  op_less,
+  op_greater,
+  op_equal,
+  op_not_equal,
+  op_negate,
+  op_not,
+  op_select,
+};
+
+struct KernelNode {
+  kernel_op op;
+  // booleans are carried as 0/1 in the same int64_t columns
+  bool isBoolean;
+  // column index for op_column, the value for op_constant and for an
+  // operator with literalOperand set
+  int64_t value;
+  // operand nodes, -1 when unused; op_select reads condition ? lhs : rhs
+  int lhs;
+  int rhs;
+  int condition;
+  // source offset of the token the node was compiled from
+  uint32_t offset;
+  // a binary operator whose integer literal right operand was folded into
+  // value; rhs is -1
+  bool literalOperand{false};
+};
+
+struct KernelNodeProfile {
+  // sampled batches the node ran in and the rows it ran over
+  size_t calls{0};
+  size_t rows{0};
+  // includes the node's operands, KernelProfile::selfNanos subtracts them
+  uint64_t totalNanos{0};
+};
+
+// Time spent per kernel node. Only every sampleEvery-th batch is timed, so
+// the clock reads stay a small fraction of the work being measured.
+struct KernelProfile {
+  size_t sampleEvery{16};
+  size_t batches{0};
+  // indexed like ColumnKernel::nodes()
+  std::vector<KernelNodeProfile> nodes{};
+
+  uint64_t selfNanos(const std::vector<KernelNode> &kernelNodes,
+                     size_t node) const;
+};
+
+// Everything a kernel run writes. Reusing one across runs, as an Isolate
+// does, avoids reallocating the batch buffers.
+struct KernelScratch {
+  std::span<const std::span<const int64_t>> columns{};
+  size_t start{0};
+  // one batch of values per node
+  std::vector<std::vector<int64_t>> values{};
+  // per op_select node, the rows taking each branch
+  std::vector<std::vector<uint32_t>> taken{};
+  std::vector<std::vector<uint32_t>> skipped{};
+  bool divisionByZero{false};
+  // set by the caller to profile runs, null otherwise
+  KernelProfile *profile{nullptr};
+  // whether the current batch is being timed
+  bool sampling{false};
+};
+
+// A Monkey expression compiled to run a column at a time. Identifiers bind
+// to input columns by name, integers and booleans are int64_t (booleans as
+// 0/1), and if/else splits each batch into selection vectors so a branch
+// only runs over the rows that take it.
+//
+// Arithmetic wraps on overflow instead of promoting like Integer does, and
+// dividing by zero yields 0 for that row and makes run() return false.
+class ColumnKernel {
+private:
+  std::vector<KernelNode> m_nodes{};
+  // owned, so the kernel outlives the names it was compiled against
+  std::vector<std::string> m_columns{};
+  int m_root{-1};
+
+  int compile(const Expression *expression);
+  int compileBlock(const BlockStatement *block);
+  int addNode(KernelNode node);
+  const int64_t *evaluate(int node, KernelScratch &scratch,
+                          const uint32_t *selection, size_t count) const;
+  const int64_t *evaluateNode(int node, KernelScratch &scratch,
+                              const uint32_t *selection, size_t count) const;
+
+public:
+  static constexpr size_t batchSize = 1024;
+
+  ColumnKernel(const Expression &expression,
+               const std::vector<std::string_view> &columns);
+
+  std::vector<std::string> m_errors{};
+
+  // columns in the order they were named at compile time, each as long as
+  // output. Returns false if any row divided by zero, or without touching
+  // output if the columns don't match that shape.
+  bool run(std::span<const std::span<const int64_t>> columns,
+           std::span<int64_t> output) const;
+  bool run(std::span<const std::span<const int64_t>> columns,
+           std::span<int64_t> output, KernelScratch &scratch) const;
+
+  // run() in pieces, for callers that stop between batches: prepare once
+  // for output of the given rows, then runBatch for each start that is a
+  // multiple of batchSize. scratch.divisionByZero holds the result.
+  bool prepare(std::span<const std::span<const int64_t>> columns, size_t rows,
+               KernelScratch &scratch) const;
+  void runBatch(std::span<int64_t> output, size_t start,
+                KernelScratch &scratch) const;
+
+  bool isBoolean() const;
+  const std::vector<KernelNode> &nodes() const;
+  const std::vector<std::string> &columns() const;
+  // the node run() starts from, -1 if compiling failed
+  int root() const;
+};
+
+// Row at a time reference over the AST with the kernel's semantics, what
+// the kernel is benchmarked and fuzzed against. Expects an expression the
+// kernel compiled without errors.
+int64_t evaluateRow(const Expression &expression,
+                    const std::vector<std::string_view> &columns,
+                    std::span<const int64_t> row, bool &divisionByZero);
+
+void testColumnKernel();
+
+#endif // COLUMN_KERNEL_H
@@ -0,0 +1,59 @@
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "compile.h"
+#include "lexer.h"
+#include "parser.h"
+#include "token.h"
+
+void testCompile() {
+  static constexpr auto snippet =
+      monkey::compile<"if (x < y) { x * 3 } else { y / 2 }">();
+
+  static_assert(snippet.tokens.size() == 18 &&
+                snippet.tokens.back().type == token_type::eof &&
+                "snippet was not scanned at compile time");
+  static_assert(getKeyword("import") == token_type::import_T &&
+                "keyword lookup is not constant");
+  static_assert(!syntaxError("let add = fn(a, b) { a + b }(1, 2);") &&
+                "valid program has a syntax error");
+  static_assert(syntaxError("let = 5;") == 4 && "let error is misplaced");
+  static_assert(syntaxError("(1 + 2") == 6 && "paren error is misplaced");
+
+  // the replayed tokens parse like the source does
+  Parser replayed(snippet.lexer());
+  auto fromTokens = replayed.parseExpression(precedence::LOWEST);
+  checkParserErrors(replayed);
+
+  Lexer lexer{std::string(snippet.source)};
+  Parser scanned(lexer);
+  auto fromSource = scanned.parseExpression(precedence::LOWEST);
+  assert(fromTokens->string() == fromSource->string() &&
+         "replayed tokens parse differently");
+
+  std::vector<std::string> inputs{
+      "let x = 5; return x;",
+      "return;",
+      "if (a) { b",
+      "fn(x, y) { x }(1)(2)",
+      "import(\"lib.mk\") + \"s\"",
+      "let f = fn(x,) { x };",
+      "if (a) { b } else c",
+      "f(1, 2",
+      "1 + ;",
+      "let x 5;",
+      "return",
+      "\"unterminated",
+      "!-a * (b - c) == d != e",
+  };
+  for (const auto &input : inputs) {
+    Lexer lexer(input);
+    Parser parser(lexer);
+    parser.parseProgram();
+    assert(syntaxError(input).has_value() == !parser.m_errors.empty() &&
+           "syntax checker disagrees with the parser");
+  }
+}
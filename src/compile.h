@@ -0,0 +1,286 @@
+#ifndef COMPILE_H
+#define COMPILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "lexer.h"
+#include "parser.h"
+#include "scanner.h"
+#include "token.h"
+
+// Parser's grammar without building anything, so it can run in constant
+// evaluation. It walks the tokens the way Parser does and stops at the
+// first error Parser would record. Changes to Parser have to be mirrored
+// here; fuzz_parser checks that the two agree.
+class SyntaxChecker {
+private:
+  std::string_view m_source;
+  ScannedToken m_cur{token_type::eof, 0, 0};
+  ScannedToken m_peek{token_type::eof, 0, 0};
+  std::optional<uint32_t> m_error{};
+
+  constexpr void nextToken() {
+    m_cur = m_peek;
+    m_peek = scanToken(m_source, m_peek.offset + m_peek.length);
+  }
+
+  constexpr bool fail(uint32_t offset) {
+    m_error = offset;
+    return false;
+  }
+
+  constexpr bool expectPeek(token_type type) {
+    if (m_peek.type != type) {
+      return fail(m_peek.offset);
+    }
+    nextToken();
+    return true;
+  }
+
+  constexpr void skipSemicolon() {
+    if (m_peek.type == token_type::semicolon) {
+      nextToken();
+    }
+  }
+
+  constexpr bool statement() {
+    switch (m_cur.type) {
+    case token_type::let:
+      if (!expectPeek(token_type::identifier) ||
+          !expectPeek(token_type::assign)) {
+        return false;
+      }
+      nextToken();
+      break;
+    case token_type::return_T:
+      nextToken();
+      if (m_cur.type == token_type::semicolon) {
+        return true;
+      }
+      break;
+    default:
+      break;
+    }
+    if (!expression(precedence::LOWEST)) {
+      return false;
+    }
+    skipSemicolon();
+    return true;
+  }
+
+  constexpr bool block() {
+    nextToken();
+    while (m_cur.type != token_type::rsquirly &&
+           m_cur.type != token_type::eof) {
+      if (!statement()) {
+        return false;
+      }
+      nextToken();
+    }
+    return true;
+  }
+
+  constexpr bool parameters() {
+    if (m_peek.type == token_type::rparen) {
+      nextToken();
+      return true;
+    }
+    bool first = true;
+    do {
+      if (!first) {
+        nextToken();
+      }
+      first = false;
+      if (!expectPeek(token_type::identifier)) {
+        return false;
+      }
+    } while (m_peek.type == token_type::comma);
+    return expectPeek(token_type::rparen);
+  }
+
+  constexpr bool arguments() {
+    if (m_peek.type == token_type::rparen) {
+      nextToken();
+      return true;
+    }
+    nextToken();
+    if (!expression(precedence::LOWEST)) {
+      return false;
+    }
+    while (m_peek.type == token_type::comma) {
+      nextToken();
+      nextToken();
+      if (!expression(precedence::LOWEST)) {
+        return false;
+      }
+    }
+    return expectPeek(token_type::rparen);
+  }
+
+  constexpr bool prefix() {
+    switch (m_cur.type) {
+    case token_type::identifier:
+    case token_type::integer:
+    case token_type::true_T:
+    case token_type::false_T:
+    case token_type::string_T:
+      return true;
+    case token_type::bang:
+    case token_type::minus:
+      nextToken();
+      return expression(precedence::PREFIX);
+    case token_type::lparen:
+      nextToken();
+      return expression(precedence::LOWEST) &&
+             expectPeek(token_type::rparen);
+    case token_type::if_T:
+      if (!expectPeek(token_type::lparen)) {
+        return false;
+      }
+      nextToken();
+      if (!expression(precedence::LOWEST) ||
+          !expectPeek(token_type::rparen) ||
+          !expectPeek(token_type::lsquirly) || !block()) {
+        return false;
+      }
+      if (m_peek.type == token_type::else_T) {
+        nextToken();
+        return expectPeek(token_type::lsquirly) && block();
+      }
+      return true;
+    case token_type::function:
+      return expectPeek(token_type::lparen) && parameters() &&
+             expectPeek(token_type::lsquirly) && block();
+    case token_type::import_T:
+      return expectPeek(token_type::lparen) &&
+             expectPeek(token_type::string_T) &&
+             expectPeek(token_type::rparen);
+    default:
+      return fail(m_cur.offset);
+    }
+  }
+
+  constexpr bool expression(precedence precedence) {
+    if (!prefix()) {
+      return false;
+    }
+    // every token with a precedence has an infix parse function
+    while (m_peek.type != token_type::semicolon &&
+           precedence < precedenceOf(m_peek.type)) {
+      nextToken();
+      if (m_cur.type == token_type::lparen) {
+        if (!arguments()) {
+          return false;
+        }
+        continue;
+      }
+      ::precedence infix = precedenceOf(m_cur.type);
+      nextToken();
+      if (!expression(infix)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+public:
+  constexpr explicit SyntaxChecker(std::string_view source)
+      : m_source(source) {
+    nextToken();
+    nextToken();
+  }
+
+  // offset of the token behind the first error Parser::parseProgram would
+  // record, nullopt if it would record none
+  constexpr std::optional<uint32_t> check() {
+    while (m_cur.type != token_type::eof) {
+      if (!statement()) {
+        return m_error;
+      }
+      nextToken();
+    }
+    return std::nullopt;
+  }
+};
+
+constexpr std::optional<uint32_t> syntaxError(std::string_view source) {
+  return SyntaxChecker(source).check();
+}
+
+namespace monkey {
+
+template <size_t N> struct FixedString {
+  char text[N]{};
+
+  consteval FixedString(const char (&literal)[N]) {
+    for (size_t i = 0; i < N; i++) {
+      text[i] = literal[i];
+    }
+  }
+
+  constexpr std::string_view view() const {
+    return std::string_view(text, N - 1);
+  }
+};
+
+// A snippet checked and scanned by the compiler. Count includes the
+// trailing eof.
+template <size_t Count> struct Snippet {
+  std::string_view source;
+  std::array<ScannedToken, Count> tokens;
+
+  // replays tokens instead of scanning source; the lexer must not outlive
+  // the snippet, so a temporary snippet cannot hand one out
+  Lexer lexer() const & { return Lexer(std::string(source), tokens); }
+  Lexer lexer() const && = delete;
+};
+
+// Only instantiated for a snippet with a syntax error, so the build fails
+// with the error's offset in the template argument.
+template <uint32_t Offset> struct SyntaxErrorAt {
+  static_assert(Offset != Offset, "Monkey snippet has a syntax error at "
+                                  "the offset SyntaxErrorAt is given");
+};
+
+consteval size_t countTokens(std::string_view source) {
+  size_t count = 0;
+  size_t position = 0;
+  ScannedToken token{token_type::eof, 0, 0};
+  do {
+    token = scanToken(source, position);
+    position = token.offset + token.length;
+    count++;
+  } while (token.type != token_type::eof);
+  return count;
+}
+
+// Checks a Monkey snippet and scans its tokens at compile time, e.g.
+//   static constexpr auto total = monkey::compile<"price * quantity">();
+//   Parser parser(total.lexer());
+// A snippet Parser would report errors for does not compile.
+template <FixedString Source> consteval auto compile() {
+  constexpr std::string_view source = Source.view();
+  constexpr std::optional<uint32_t> error = syntaxError(source);
+  if constexpr (error.has_value()) {
+    SyntaxErrorAt<*error>{};
+  }
+
+  Snippet<countTokens(source)> snippet{source, {}};
+  size_t position = 0;
+  for (ScannedToken &token : snippet.tokens) {
+    token = scanToken(source, position);
+    position = token.offset + token.length;
+  }
+  return snippet;
+}
+
+} // namespace monkey
+
+void testCompile();
+
+#endif // COMPILE_H
@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+
+#include "integer.h"
+
+// LimbBuffer
+size_t LimbBuffer::size() const { return m_size; }
+
+uint32_t *LimbBuffer::data() {
+  return m_heap.empty() ? m_inline : m_heap.data();
+}
+
+const uint32_t *LimbBuffer::data() const {
+  return m_heap.empty() ? m_inline : m_heap.data();
+}
+
+uint32_t LimbBuffer::operator[](size_t i) const { return data()[i]; }
+
+uint32_t &LimbBuffer::operator[](size_t i) { return data()[i]; }
+
+void LimbBuffer::resize(size_t size) {
+  if (m_heap.empty() && size <= inlineCapacity) {
+    for (size_t i = m_size; i < size; i++) {
+      m_inline[i] = 0;
+    }
+  } else {
+    // once spilled the limbs stay on the heap
+    if (m_heap.empty()) {
+      m_heap.assign(m_inline, m_inline + m_size);
+    }
+    m_heap.resize(std::max<size_t>(size, 1), 0);
+  }
+  m_size = size;
+}
+
+void LimbBuffer::trim() {
+  size_t size = m_size;
+  while (size > 0 && (*this)[size - 1] == 0) {
+    size--;
+  }
+  resize(size);
+}
+
+// Magnitude helpers, all operate on trimmed buffers
+static int compareMagnitudes(const LimbBuffer &a, const LimbBuffer &b) {
+  if (a.size() != b.size()) {
+    return a.size() < b.size() ? -1 : 1;
+  }
+  for (size_t i = a.size(); i > 0; i--) {
+    if (a[i - 1] != b[i - 1]) {
+      return a[i - 1] < b[i - 1] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+static LimbBuffer addMagnitudes(const LimbBuffer &a, const LimbBuffer &b) {
+  const LimbBuffer &longer = a.size() >= b.size() ? a : b;
+  const LimbBuffer &shorter = a.size() >= b.size() ? b : a;
+  LimbBuffer sum{};
+  sum.resize(longer.size() + 1);
+  uint64_t carry = 0;
+  for (size_t i = 0; i < longer.size(); i++) {
+    uint64_t limb = carry + longer[i] + (i < shorter.size() ? shorter[i] : 0);
+    sum[i] = static_cast<uint32_t>(limb);
+    carry = limb >> 32;
+  }
+  sum[longer.size()] = static_cast<uint32_t>(carry);
+  sum.trim();
+  return sum;
+}
+
+// requires a >= b
+static LimbBuffer subtractMagnitudes(const LimbBuffer &a,
+                                     const LimbBuffer &b) {
+  LimbBuffer difference{};
+  difference.resize(a.size());
+  int64_t borrow = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    int64_t limb = static_cast<int64_t>(a[i]) - borrow -
+                   static_cast<int64_t>(i < b.size() ? b[i] : 0);
+    borrow = limb < 0 ? 1 : 0;
+    difference[i] = static_cast<uint32_t>(limb + (borrow << 32));
+  }
+  difference.trim();
+  return difference;
+}
+
+static LimbBuffer multiplyMagnitudes(const LimbBuffer &a,
+                                     const LimbBuffer &b) {
+  LimbBuffer product{};
+  product.resize(a.size() + b.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    uint64_t carry = 0;
+    for (size_t j = 0; j < b.size(); j++) {
+      uint64_t limb = static_cast<uint64_t>(a[i]) * b[j] + product[i + j] +
+                      carry;
+      product[i + j] = static_cast<uint32_t>(limb);
+      carry = limb >> 32;
+    }
+    product[i + b.size()] = static_cast<uint32_t>(carry);
+  }
+  product.trim();
+  return product;
+}
+
+// magnitude = magnitude * factor + addend
+static void multiplyAddSmall(LimbBuffer &magnitude, uint32_t factor,
+                             uint32_t addend) {
+  uint64_t carry = addend;
+  for (size_t i = 0; i < magnitude.size(); i++) {
+    uint64_t limb = static_cast<uint64_t>(magnitude[i]) * factor + carry;
+    magnitude[i] = static_cast<uint32_t>(limb);
+    carry = limb >> 32;
+  }
+  if (carry != 0) {
+    magnitude.resize(magnitude.size() + 1);
+    magnitude[magnitude.size() - 1] = static_cast<uint32_t>(carry);
+  }
+}
+
+// divides in place and returns the remainder
+static uint32_t divideSmall(LimbBuffer &magnitude, uint32_t divisor) {
+  uint64_t remainder = 0;
+  for (size_t i = magnitude.size(); i > 0; i--) {
+    uint64_t limb = (remainder << 32) | magnitude[i - 1];
+    magnitude[i - 1] = static_cast<uint32_t>(limb / divisor);
+    remainder = limb % divisor;
+  }
+  magnitude.trim();
+  return static_cast<uint32_t>(remainder);
+}
+
+// shift-subtract long division. Integer::divide takes this path whenever
+// either side is a bignum, and for INT64_MIN / -1
+static LimbBuffer divideMagnitudes(const LimbBuffer &a, const LimbBuffer &b) {
+  LimbBuffer quotient{};
+  quotient.resize(a.size());
+  LimbBuffer remainder{};
+  for (size_t bit = a.size() * 32; bit > 0; bit--) {
+    size_t i = bit - 1;
+    multiplyAddSmall(remainder, 2, (a[i / 32] >> (i % 32)) & 1);
+    remainder.trim();
+    if (compareMagnitudes(remainder, b) >= 0) {
+      remainder = subtractMagnitudes(remainder, b);
+      quotient[i / 32] |= uint32_t{1} << (i % 32);
+    }
+  }
+  quotient.trim();
+  return quotient;
+}
+
+// Integer
+Integer::Integer(int64_t value) : m_value(value) {}
+
+Integer::Integer(const Integer &other) {
+  if (const Bignum *big = other.big()) {
+    m_value = std::make_unique<Bignum>(*big);
+  } else {
+    m_value = other.small();
+  }
+}
+
+Integer &Integer::operator=(const Integer &other) {
+  if (this != &other) {
+    *this = Integer(other);
+  }
+  return *this;
+}
+
+Integer Integer::fromMagnitude(bool negative, LimbBuffer magnitude) {
+  magnitude.trim();
+  if (magnitude.size() <= 2) {
+    uint64_t value = magnitude.size() > 0 ? magnitude[0] : 0;
+    if (magnitude.size() == 2) {
+      value |= static_cast<uint64_t>(magnitude[1]) << 32;
+    }
+    const uint64_t max = std::numeric_limits<int64_t>::max();
+    if (!negative && value <= max) {
+      return Integer(static_cast<int64_t>(value));
+    }
+    if (negative && value <= max + 1) {
+      return Integer(static_cast<int64_t>(0 - value));
+    }
+  }
+
+  Integer big{};
+  big.m_value =
+      std::make_unique<Bignum>(Bignum{negative, std::move(magnitude)});
+  return big;
+}
+
+const Integer::Bignum *Integer::big() const {
+  auto *big = std::get_if<std::unique_ptr<Bignum>>(&m_value);
+  return big ? big->get() : nullptr;
+}
+
+LimbBuffer Integer::magnitude() const {
+  if (const Bignum *big = this->big()) {
+    return big->magnitude;
+  }
+  int64_t small = this->small();
+  uint64_t value = small < 0 ? 0 - static_cast<uint64_t>(small)
+                             : static_cast<uint64_t>(small);
+  LimbBuffer magnitude{};
+  magnitude.resize(2);
+  magnitude[0] = static_cast<uint32_t>(value);
+  magnitude[1] = static_cast<uint32_t>(value >> 32);
+  magnitude.trim();
+  return magnitude;
+}
+
+bool Integer::negative() const {
+  const Bignum *big = this->big();
+  return big ? big->negative : small() < 0;
+}
+
+std::optional<Integer> Integer::parse(std::string_view digits) {
+  if (digits.empty()) {
+    return std::nullopt;
+  }
+
+  int64_t value = 0;
+  auto [end, ec] =
+      std::from_chars(digits.data(), digits.data() + digits.size(), value);
+  if (ec == std::errc() && end == digits.data() + digits.size()) {
+    return Integer(value);
+  }
+  if (ec != std::errc::result_out_of_range) {
+    return std::nullopt;
+  }
+
+  // too big for an int64_t, accumulate nine digits at a time
+  LimbBuffer magnitude{};
+  for (size_t i = 0; i < digits.size(); i += 9) {
+    std::string_view chunk = digits.substr(i, 9);
+    uint32_t chunkValue = 0;
+    uint32_t scale = 1;
+    for (char ch : chunk) {
+      if (ch < '0' || ch > '9') {
+        return std::nullopt;
+      }
+      chunkValue = chunkValue * 10 + static_cast<uint32_t>(ch - '0');
+      scale *= 10;
+    }
+    multiplyAddSmall(magnitude, scale, chunkValue);
+  }
+  return fromMagnitude(false, std::move(magnitude));
+}
+
+bool Integer::isSmall() const {
+  return std::holds_alternative<int64_t>(m_value);
+}
+
+int64_t Integer::small() const {
+  auto *small = std::get_if<int64_t>(&m_value);
+  return small ? *small : 0;
+}
+
+std::string Integer::string() const {
+  const Bignum *big = this->big();
+  if (!big) {
+    return std::to_string(small());
+  }
+
+  LimbBuffer magnitude = big->magnitude;
+  std::string digits{};
+  while (magnitude.size() > 0) {
+    uint32_t chunk = divideSmall(magnitude, 1000000000);
+    for (int i = 0; i < 9 && (magnitude.size() > 0 || chunk != 0); i++) {
+      digits += static_cast<char>('0' + chunk % 10);
+      chunk /= 10;
+    }
+  }
+  if (big->negative) {
+    digits += '-';
+  }
+  std::reverse(digits.begin(), digits.end());
+  return digits;
+}
+
+Integer Integer::operator-() const {
+  if (isSmall() && small() != std::numeric_limits<int64_t>::min()) {
+    return Integer(-small());
+  }
+  return fromMagnitude(!negative(), magnitude());
+}
+
+Integer operator+(const Integer &a, const Integer &b) {
+  int64_t sum = 0;
+  if (a.isSmall() && b.isSmall() &&
+      !__builtin_add_overflow(a.small(), b.small(), &sum)) {
+    return Integer(sum);
+  }
+
+  LimbBuffer left = a.magnitude();
+  LimbBuffer right = b.magnitude();
+  if (a.negative() == b.negative()) {
+    return Integer::fromMagnitude(a.negative(), addMagnitudes(left, right));
+  }
+  if (compareMagnitudes(left, right) >= 0) {
+    return Integer::fromMagnitude(a.negative(),
+                                  subtractMagnitudes(left, right));
+  }
+  return Integer::fromMagnitude(b.negative(), subtractMagnitudes(right, left));
+}
+
+Integer operator-(const Integer &a, const Integer &b) {
+  int64_t difference = 0;
+  if (a.isSmall() && b.isSmall() &&
+      !__builtin_sub_overflow(a.small(), b.small(), &difference)) {
+    return Integer(difference);
+  }
+  return a + -b;
+}
+
+Integer operator*(const Integer &a, const Integer &b) {
+  int64_t product = 0;
+  if (a.isSmall() && b.isSmall() &&
+      !__builtin_mul_overflow(a.small(), b.small(), &product)) {
+    return Integer(product);
+  }
+  return Integer::fromMagnitude(
+      a.negative() != b.negative(),
+      multiplyMagnitudes(a.magnitude(), b.magnitude()));
+}
+
+std::optional<Integer> Integer::divide(const Integer &divisor) const {
+  if (divisor == Integer(0)) {
+    return std::nullopt;
+  }
+  // INT64_MIN / -1 is the one small quotient that overflows
+  if (isSmall() && divisor.isSmall() &&
+      !(small() == std::numeric_limits<int64_t>::min() &&
+        divisor.small() == -1)) {
+    return Integer(small() / divisor.small());
+  }
+  return fromMagnitude(negative() != divisor.negative(),
+                       divideMagnitudes(magnitude(), divisor.magnitude()));
+}
+
+bool operator==(const Integer &a, const Integer &b) {
+  const Integer::Bignum *left = a.big();
+  const Integer::Bignum *right = b.big();
+  if (!left || !right) {
+    // bignums are always outside the int64_t range
+    return !left && !right && a.small() == b.small();
+  }
+  return left->negative == right->negative &&
+         compareMagnitudes(left->magnitude, right->magnitude) == 0;
+}
+
+bool operator<(const Integer &a, const Integer &b) {
+  if (a.isSmall() && b.isSmall()) {
+    return a.small() < b.small();
+  }
+  if (a.negative() != b.negative()) {
+    return a.negative();
+  }
+  int cmp = compareMagnitudes(a.magnitude(), b.magnitude());
+  return a.negative() ? cmp > 0 : cmp < 0;
+}
+
+bool operator>(const Integer &a, const Integer &b) { return b < a; }
+
+void testInteger() {
+  [[maybe_unused]] const int64_t max = std::numeric_limits<int64_t>::max();
+  [[maybe_unused]] const int64_t min = std::numeric_limits<int64_t>::min();
+
+  Integer five = Integer::parse("5").value();
+  assert(five.isSmall() && five == Integer(5) && "5 did not parse as small");
+
+  Integer largest = Integer::parse("9223372036854775807").value();
+  assert(largest.isSmall() && largest == Integer(max) &&
+         "INT64_MAX did not parse as small");
+
+  Integer promoted = largest + Integer(1);
+  assert(!promoted.isSmall() && "INT64_MAX + 1 did not promote");
+  assert(promoted.string() == "9223372036854775808" &&
+         "INT64_MAX + 1 printed incorrectly");
+  assert(promoted - Integer(1) == largest && "promoted value did not demote");
+
+  Integer huge = Integer::parse("123456789012345678901234567890").value();
+  assert(!huge.isSmall() && "30 digit literal did not promote");
+  assert(huge.string() == "123456789012345678901234567890" &&
+         "30 digit literal did not round trip");
+
+  // bignums live out of line, copies don't share their limbs
+  static_assert(sizeof(Integer) <= 2 * sizeof(int64_t),
+                "small integers carry bignum storage inline");
+  Integer copy = huge;
+  copy = copy + Integer(1);
+  assert(huge.string() == "123456789012345678901234567890" &&
+         copy.string() == "123456789012345678901234567891" &&
+         "copying a bignum shared its limbs");
+  Integer moved = std::move(copy);
+  assert(moved.string() == "123456789012345678901234567891" &&
+         "moving a bignum lost its limbs");
+
+  Integer squared = huge * huge;
+  assert(squared.string() == "152415787532388367504953515625361987875019"
+                             "05199875019052100" &&
+         "bignum multiplication is wrong");
+  assert(squared.divide(huge).value() == huge && "bignum division is wrong");
+  assert((-huge).string() == "-123456789012345678901234567890" &&
+         "bignum negation is wrong");
+  assert(-huge < Integer(min) && Integer(max) < huge &&
+         "bignum ordering is wrong");
+
+  assert(!(Integer(min) * Integer(-1)).isSmall() &&
+         "INT64_MIN * -1 did not promote");
+  assert(Integer(min).divide(Integer(-1)).value().string() ==
+             "9223372036854775808" &&
+         "INT64_MIN / -1 did not promote");
+  assert(Integer(-7).divide(Integer(2)).value() == Integer(-3) &&
+         "division does not truncate toward zero");
+  assert(!Integer(1).divide(Integer(0)) && "division by zero not reported");
+  assert(!Integer::parse("12a") && "non digits were accepted");
+}
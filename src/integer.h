@@ -0,0 +1,83 @@
+#ifndef INTEGER_H
+#define INTEGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+// Little endian 32-bit limbs. The first few live inline so values just past
+// the int64_t range never touch the heap.
+class LimbBuffer {
+private:
+  static constexpr size_t inlineCapacity = 4;
+  uint32_t m_inline[inlineCapacity]{};
+  std::vector<uint32_t> m_heap{};
+  size_t m_size{0};
+
+public:
+  size_t size() const;
+  uint32_t *data();
+  const uint32_t *data() const;
+  uint32_t operator[](size_t i) const;
+  uint32_t &operator[](size_t i);
+  // grows with zeroed limbs or drops the top ones
+  void resize(size_t size);
+  // drops leading zero limbs
+  void trim();
+};
+
+// Monkey integer. Values stay an int64_t until an operation overflows, at
+// which point they promote to a sign/magnitude bignum.
+class Integer {
+private:
+  // only ever holds values outside the int64_t range
+  struct Bignum {
+    bool negative{false};
+    LimbBuffer magnitude{};
+  };
+
+  // bignums live out of line, so a small value is one word plus the tag
+  std::variant<int64_t, std::unique_ptr<Bignum>> m_value{int64_t{0}};
+
+  static Integer fromMagnitude(bool negative, LimbBuffer magnitude);
+  const Bignum *big() const;
+  LimbBuffer magnitude() const;
+  bool negative() const;
+
+public:
+  Integer() = default;
+  Integer(int64_t value);
+  // copies deep-copy a bignum, moves hand its storage over
+  Integer(const Integer &other);
+  Integer &operator=(const Integer &other);
+  Integer(Integer &&other) noexcept = default;
+  Integer &operator=(Integer &&other) noexcept = default;
+
+  // decimal digits only, as produced by the lexer
+  static std::optional<Integer> parse(std::string_view digits);
+
+  bool isSmall() const;
+  // 0 for a bignum
+  int64_t small() const;
+  std::string string() const;
+
+  Integer operator-() const;
+  friend Integer operator+(const Integer &a, const Integer &b);
+  friend Integer operator-(const Integer &a, const Integer &b);
+  friend Integer operator*(const Integer &a, const Integer &b);
+  // truncates toward zero, nullopt when dividing by zero
+  std::optional<Integer> divide(const Integer &divisor) const;
+
+  friend bool operator==(const Integer &a, const Integer &b);
+  friend bool operator<(const Integer &a, const Integer &b);
+  friend bool operator>(const Integer &a, const Integer &b);
+};
+
+void testInteger();
+
+#endif // INTEGER_H
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "column_kernel.h"
+#include "isolate.h"
+#include "lexer.h"
+#include "parser.h"
+
+// Isolate
+bool Isolate::run(const ColumnKernel &kernel,
+                  std::span<const std::span<const int64_t>> columns,
+                  std::span<int64_t> output) {
+  m_runs++;
+  return kernel.run(columns, output, m_scratch);
+}
+
+size_t Isolate::runs() const { return m_runs; }
+
+// Isolate Pool
+IsolatePool::IsolatePool(size_t threads) {
+  for (size_t i = 0; i < std::max<size_t>(threads, 1); i++) {
+    m_workers.emplace_back([this]() { work(); });
+  }
+}
+
+IsolatePool::~IsolatePool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_ready.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+}
+
+void IsolatePool::work() {
+  Isolate isolate{};
+  while (true) {
+    Job job{};
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_ready.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+      // drain what was queued before shutting down
+      if (m_jobs.empty()) {
+        return;
+      }
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    job(isolate);
+  }
+}
+
+std::future<bool>
+IsolatePool::submit(std::shared_ptr<const ColumnKernel> kernel,
+                    std::vector<std::span<const int64_t>> columns,
+                    std::span<int64_t> output) {
+  auto task = std::make_shared<std::packaged_task<bool(Isolate &)>>(
+      [kernel = std::move(kernel), columns = std::move(columns),
+       output](Isolate &isolate) {
+        return isolate.run(*kernel, columns, output);
+      });
+  std::future<bool> result = task->get_future();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back([task](Isolate &isolate) { (*task)(isolate); });
+  }
+  m_ready.notify_one();
+  return result;
+}
+
+size_t IsolatePool::size() const { return m_workers.size(); }
+
+void testIsolatePool() {
+  std::vector<std::string> inputs{"x * 2 + y > 10",
+                                  "if (x < y) { x - y } else { y / x }"};
+  std::vector<std::string_view> names{"x", "y"};
+
+  std::vector<std::shared_ptr<const ColumnKernel>> kernels{};
+  for (const auto &input : inputs) {
+    Lexer lexer(input);
+    Parser parser(lexer);
+    auto expression = parser.parseExpression(precedence::LOWEST);
+    checkParserErrors(parser);
+    kernels.push_back(std::make_shared<const ColumnKernel>(*expression, names));
+  }
+
+  const size_t jobs = 64;
+  const size_t rows = 1500;
+  std::vector<std::vector<int64_t>> x(jobs);
+  std::vector<std::vector<int64_t>> y(jobs);
+  std::vector<std::vector<int64_t>> outputs(jobs, std::vector<int64_t>(rows));
+  for (size_t job = 0; job < jobs; job++) {
+    for (size_t row = 0; row < rows; row++) {
+      x[job].push_back(static_cast<int64_t>((job * 31 + row * 7) % 41) - 20);
+      y[job].push_back(static_cast<int64_t>((job * 17 + row * 3) % 37) - 18);
+    }
+  }
+
+  std::vector<std::future<bool>> results{};
+  {
+    IsolatePool pool(4);
+    assert(pool.size() == 4 && "pool did not start 4 workers");
+    for (size_t job = 0; job < jobs; job++) {
+      results.push_back(pool.submit(kernels[job % kernels.size()],
+                                    {x[job], y[job]}, outputs[job]));
+    }
+    for (auto &result : results) {
+      result.wait();
+    }
+  }
+
+  for (size_t job = 0; job < jobs; job++) {
+    std::vector<std::span<const int64_t>> columns{x[job], y[job]};
+    std::vector<int64_t> expected(rows);
+    [[maybe_unused]] bool clean =
+        kernels[job % kernels.size()]->run(columns, expected);
+    assert(results[job].get() == clean &&
+           "pooled run reported a different division by zero");
+    assert(outputs[job] == expected && "pooled run differs from a direct run");
+  }
+}
@@ -0,0 +1,63 @@
+#ifndef ISOLATE_H
+#define ISOLATE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "column_kernel.h"
+
+// Execution state for one thread. Compiled kernels are immutable and shared
+// between isolates without copying; everything a run writes lives here, so
+// isolates never touch each other's memory.
+class Isolate {
+private:
+  KernelScratch m_scratch{};
+  size_t m_runs{0};
+
+public:
+  bool run(const ColumnKernel &kernel,
+           std::span<const std::span<const int64_t>> columns,
+           std::span<int64_t> output);
+  size_t runs() const;
+};
+
+// Fixed set of worker threads, each owning an Isolate. The job queue is the
+// only state the workers share.
+class IsolatePool {
+private:
+  using Job = std::function<void(Isolate &)>;
+
+  std::vector<std::thread> m_workers{};
+  std::deque<Job> m_jobs{};
+  std::mutex m_mutex{};
+  std::condition_variable m_ready{};
+  bool m_stopping{false};
+
+  void work();
+
+public:
+  explicit IsolatePool(size_t threads);
+  ~IsolatePool();
+  IsolatePool(const IsolatePool &) = delete;
+  IsolatePool &operator=(const IsolatePool &) = delete;
+
+  // columns and output must outlive the returned future; the future holds
+  // what ColumnKernel::run returned
+  std::future<bool> submit(std::shared_ptr<const ColumnKernel> kernel,
+                           std::vector<std::span<const int64_t>> columns,
+                           std::span<int64_t> output);
+  size_t size() const;
+};
+
+void testIsolatePool();
+
+#endif // ISOLATE_H
@@ -1,143 +1,61 @@
+#include <algorithm>
 #include <cassert>
-#include <cctype>
-#include <ctype.h>
 #include <iostream>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "lexer.h"
+#include "scanner.h"
 #include "token.h"
 
 Lexer::Lexer(std::string input)
-    : m_input(input), m_position(0), m_read_position(1), m_byte{input[0]} {}
+    : m_input(std::move(input)), m_position(0), m_tokens(), m_next(0),
+      m_pool(std::make_shared<LiteralPool>()) {}
 
-void Lexer::readChar() {
-  if (m_read_position >= m_input.size()) {
-    m_byte = 0;
-  } else {
-    m_byte = m_input[m_read_position];
-  }
-  m_position = m_read_position;
-  m_read_position += 1;
-}
+Lexer::Lexer(std::string input, std::span<const ScannedToken> tokens)
+    : m_input(std::move(input)), m_position(0), m_tokens(tokens), m_next(0),
+      m_pool(std::make_shared<LiteralPool>()) {}
 
-char Lexer::peekChar() const {
-  if (m_read_position >= m_input.size()) {
-    return 0;
+Token Lexer::nextToken() {
+  ScannedToken scanned{};
+  if (m_tokens.empty()) {
+    scanned = scanToken(m_input, m_position);
+    m_position = scanned.offset + scanned.length;
   } else {
-    return m_input[m_read_position];
-  }
-}
-
-std::string Lexer::readNumber() {
-  std::string number{};
-  do {
-    number += m_byte;
-    if (isdigit(peekChar())) {
-      readChar();
-    } else {
-      break;
-    }
-  } while (isdigit(m_byte));
-
-  return number;
-}
-
-bool Lexer::isLetter(char ch) const { return isalpha(ch) || ch == '_'; }
-
-std::string Lexer::readIdentifier() {
-  std::string word{};
-  while (isLetter(m_byte)) {
-    word += m_byte;
-    if (isalpha(peekChar())) {
-      readChar();
-    } else {
-      break;
-    }
+    // a replayed table ends in eof, which repeats like it does when scanning
+    scanned = m_tokens[m_next];
+    m_next = std::min(m_next + 1, m_tokens.size() - 1);
   }
-  return word;
-};
 
-void Lexer::skipWhitespace(char m_byte) {
-  if (m_byte == ' ' || m_byte == '\n') {
-    readChar();
+  std::string_view text =
+      std::string_view(m_input).substr(scanned.offset, scanned.length);
+  switch (scanned.type) {
+  case token_type::identifier:
+  case token_type::integer:
+    return Token(scanned.type, m_pool->intern(text), scanned.offset);
+  case token_type::string_T:
+    return Token(scanned.type, m_pool->intern(text.substr(1, text.size() - 2)),
+                 scanned.offset);
+  case token_type::illegal:
+    // the offending byte, or the quote an unterminated string starts with
+    return Token(scanned.type, m_pool->intern(text.substr(0, 1)),
+                 scanned.offset);
+  default:
+    return Token(scanned.type, tokenText(scanned.type), scanned.offset);
   }
 }
 
-Token Lexer::nextToken() {
-  Token tok{};
-  skipWhitespace(m_byte);
-  switch (m_byte) {
-  case '=':
-    if ('=' == peekChar()) {
-      readChar();
-      tok = Token(token_type::equal, "==");
-    } else {
-      tok = Token(token_type::assign, std::string(1, m_byte));
-    }
-    break;
-  case ';':
-    tok = Token(token_type::semicolon, std::string(1, m_byte));
-    break;
-  case '(':
-    tok = Token(token_type::lparen, std::string(1, m_byte));
-    break;
-  case ')':
-    tok = Token(token_type::rparen, std::string(1, m_byte));
-    break;
-  case ',':
-    tok = Token(token_type::comma, std::string(1, m_byte));
-    break;
-  case '+':
-    tok = Token(token_type::plus, std::string(1, m_byte));
-    break;
-  case '-':
-    tok = Token(token_type::minus, std::string(1, m_byte));
-    break;
-  case '{':
-    tok = Token(token_type::lsquirly, std::string(1, m_byte));
-    break;
-  case '}':
-    tok = Token(token_type::rsquirly, std::string(1, m_byte));
-    break;
-  case '!':
-    if ('=' == peekChar()) {
-      readChar();
-      tok = Token(token_type::not_equal, "!=");
-    } else {
-      tok = Token(token_type::bang, std::string(1, m_byte));
-    }
-    break;
-  case '<':
-    tok = Token(token_type::lt, std::string(1, m_byte));
-    break;
-  case '>':
-    tok = Token(token_type::gt, std::string(1, m_byte));
-    break;
-  case '*':
-    tok = Token(token_type::asterisk, std::string(1, m_byte));
-    break;
-  case '/':
-    tok = Token(token_type::slash, std::string(1, m_byte));
-    break;
-  case '\0':
-    tok = Token(token_type::eof, std::string(0, m_byte));
-    break;
-  default:
-    if (isalpha(m_byte)) {
-      std::string word = readIdentifier();
-      token_type keyword = ::getKeyword(word);
-      tok = Token(keyword, word);
-    } else if (isdigit(m_byte)) {
-      std::string number = readNumber();
-      tok = Token(token_type::integer, number);
-    } else {
-      tok = Token(token_type::illegal, std::string(1, m_byte));
-    }
-    break;
+std::shared_ptr<LiteralPool> Lexer::pool() const { return m_pool; }
+
+SourceLocation Lexer::location(uint32_t offset) const {
+  if (!m_lineIndex) {
+    m_lineIndex.emplace(m_input);
   }
-  readChar();
-  return tok;
+  return m_lineIndex->locate(offset);
 }
 
 void Lexer::print() {
@@ -266,3 +184,58 @@ int lexerTest() {
   }
   return 1;
 }
+
+void testLexerEdgeCases() {
+  Lexer empty("");
+  assert(empty.nextToken().type == token_type::eof &&
+         "empty input does not produce eof");
+
+  std::string input = "  let foo_bar1 =\t\t_x;\r\n";
+
+  std::vector<Token> tests{
+      Token(token_type::let, "let", 2),
+      Token(token_type::identifier, "foo_bar1", 6),
+      Token(token_type::assign, "=", 15),
+      Token(token_type::identifier, "_x", 18),
+      Token(token_type::semicolon, ";", 20),
+      Token(token_type::eof, "", 23),
+  };
+
+  Lexer test_lexer(input);
+
+  for ([[maybe_unused]] const Token &test_token : tests) {
+    [[maybe_unused]] Token lexer_token = test_lexer.nextToken();
+
+    assert(test_token.type == lexer_token.type &&
+           "test token does not match token in lexer");
+    assert(test_token.literal == lexer_token.literal &&
+           "test literal does not match token in lexer");
+    assert(test_token.offset == lexer_token.offset &&
+           "test offset does not match token in lexer");
+  }
+
+  Lexer strings(R"(import("lib/math.mk") "" "a b")");
+  std::vector<Token> stringTests{
+      Token(token_type::import_T, "import", 0),
+      Token(token_type::lparen, "(", 6),
+      Token(token_type::string_T, "lib/math.mk", 7),
+      Token(token_type::rparen, ")", 20),
+      Token(token_type::string_T, "", 22),
+      Token(token_type::string_T, "a b", 25),
+      Token(token_type::eof, "", 30),
+  };
+  for ([[maybe_unused]] const Token &test_token : stringTests) {
+    [[maybe_unused]] Token lexer_token = strings.nextToken();
+    assert(test_token.type == lexer_token.type &&
+           test_token.literal == lexer_token.literal &&
+           test_token.offset == lexer_token.offset &&
+           "string token does not match");
+  }
+
+  Lexer unterminated("x \"abc");
+  unterminated.nextToken();
+  assert(unterminated.nextToken().type == token_type::illegal &&
+         "unterminated string is not illegal");
+  assert(unterminated.nextToken().type == token_type::eof &&
+         "lexing continued past an unterminated string");
+}
@@ -2,32 +2,45 @@
 #define LEXER_H
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "literal_pool.h"
+#include "scanner.h"
+#include "source.h"
 #include "token.h"
 
 class Lexer {
 private:
   std::string m_input;
+  // where the next token is scanned from
   size_t m_position;
-  size_t m_read_position;
-  char m_byte;
-
-  void readChar();
-  char peekChar() const;
-  std::string readNumber();
-  bool isLetter(char ch) const;
-  std::string readIdentifier();
-  void skipWhitespace(char m_byte);
-  token_type getKeyword(const std::string &word) const;
+  // tokens scanned ahead of time, see monkey::compile; empty when scanning
+  std::span<const ScannedToken> m_tokens;
+  size_t m_next;
+  // built on the first call to location()
+  mutable std::optional<LineIndex> m_lineIndex;
+  // backs the literal of every identifier, integer, string and illegal
+  // token
+  std::shared_ptr<LiteralPool> m_pool;
 
 public:
   Lexer(std::string input);
+  // replays tokens scanned from input instead of scanning it; the table
+  // has to end in eof and outlive the lexer
+  Lexer(std::string input, std::span<const ScannedToken> tokens);
   Token nextToken();
+  SourceLocation location(uint32_t offset) const;
+  std::shared_ptr<LiteralPool> pool() const;
   void print();
 };
 
 int lexerTest();
+void testLexerEdgeCases();
 
 #endif // LEXER_H
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "literal_pool.h"
+
+LiteralPool::LiteralPool(size_t firstBlockSize)
+    : m_firstBlockSize(firstBlockSize > 0 ? firstBlockSize
+                                          : defaultBlockSize) {}
+
+std::string_view LiteralPool::intern(std::string_view text) {
+  if (text.empty()) {
+    return std::string_view{};
+  }
+
+  auto found = m_literals.find(text);
+  if (found != m_literals.end()) {
+    return *found;
+  }
+
+  if (m_blocks.empty() || text.size() > m_blockSize - m_blockUsed) {
+    size_t next = m_blocks.empty() ? m_firstBlockSize : m_blockSize * 2;
+    m_blockSize = std::max(next, text.size());
+    m_blocks.push_back(std::make_unique<char[]>(m_blockSize));
+    m_blockUsed = 0;
+    m_capacity += m_blockSize;
+  }
+
+  char *storage = m_blocks.back().get() + m_blockUsed;
+  std::memcpy(storage, text.data(), text.size());
+  m_blockUsed += text.size();
+  m_bytes += text.size();
+
+  std::string_view literal(storage, text.size());
+  m_literals.insert(literal);
+  return literal;
+}
+
+size_t LiteralPool::size() const { return m_literals.size(); }
+
+size_t LiteralPool::bytes() const { return m_bytes; }
+
+size_t LiteralPool::capacity() const { return m_capacity; }
+
+void testLiteralPool() {
+  LiteralPool pool(8);
+
+  std::string first = "result";
+  std::string second = "result";
+  [[maybe_unused]] std::string_view a = pool.intern(first);
+  [[maybe_unused]] std::string_view b = pool.intern(second);
+
+  assert(a == "result" && "interned literal does not match its text");
+  assert(a.data() == b.data() && "repeated literal was stored twice");
+  assert(a.data() != first.data() && "pool did not copy the literal");
+  assert(pool.size() == 1 && pool.bytes() == 6 && "pool counts are wrong");
+  assert(pool.capacity() == 8 && "first block is not the requested size");
+
+  // the second block doubles the first
+  pool.intern("next");
+  assert(pool.capacity() == 8 + 16 && "pool did not grow geometrically");
+
+  // overflow the current block, earlier views must survive
+  [[maybe_unused]] std::string_view big = pool.intern(std::string(5000, 'x'));
+  [[maybe_unused]] std::string_view other = pool.intern("other");
+
+  assert(a == "result" && "view moved when the pool grew");
+  assert(big.size() == 5000 && other == "other" &&
+         "literals stored past the first block are wrong");
+  assert(pool.size() == 4 && "pool did not count distinct literals");
+  assert(pool.bytes() <= pool.capacity() && "pool stored past its blocks");
+  assert(pool.intern("").empty() && "empty literal was not empty");
+}
@@ -0,0 +1,44 @@
+#ifndef LITERAL_POOL_H
+#define LITERAL_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Deduplicated storage for identifier and integer literal text. Each lexer
+// owns one for its parse session; tokens and AST nodes hold views into it,
+// so a name repeated a thousand times is stored once. Views stay valid for
+// the lifetime of the pool.
+class LiteralPool {
+private:
+  static constexpr size_t defaultBlockSize = 256;
+
+  // blocks are never reallocated, which is what keeps views stable
+  std::vector<std::unique_ptr<char[]>> m_blocks{};
+  size_t m_blockUsed{0};
+  size_t m_blockSize{0};
+  size_t m_firstBlockSize;
+  size_t m_bytes{0};
+  size_t m_capacity{0};
+  std::unordered_set<std::string_view> m_literals{};
+
+public:
+  // the first block is small and each later one doubles, so a session
+  // with few distinct literals does not reserve a buffer the size of its
+  // input, and a large one still needs only a logarithmic number of blocks
+  explicit LiteralPool(size_t firstBlockSize = defaultBlockSize);
+
+  std::string_view intern(std::string_view text);
+  // distinct literals stored
+  size_t size() const;
+  // bytes of literal text stored
+  size_t bytes() const;
+  // bytes reserved across all blocks
+  size_t capacity() const;
+};
+
+void testLiteralPool();
+
+#endif // LITERAL_POOL_H
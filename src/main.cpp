@@ -1,9 +1,19 @@
 #include <iostream>
 
 #include "ast.h"
+#include "column_kernel.h"
+#include "compile.h"
+#include "integer.h"
+#include "isolate.h"
 #include "lexer.h"
+#include "literal_pool.h"
+#include "module_loader.h"
 #include "parser.h"
+#include "profiler.h"
+#include "purity.h"
 #include "repl.h"
+#include "scheduler.h"
+#include "source.h"
 
 int main() {
   // TODO: clean up test cases.
@@ -13,6 +23,25 @@ int main() {
   // testString();
   // testIdentifierExpression();
   testIntegerLiteralExpression();
+  testLexerEdgeCases();
+  testLineIndex();
+  testInteger();
+  testLiteralPool();
+  testColumnKernel();
+  testIsolatePool();
+  testScheduler();
+  testProfiler();
+  testPurity();
+  testModuleLoader();
+  testCompile();
+  testLargeIntegerLiteralExpression();
+  testCallExpressionParsing();
+  testPrefixExpressions();
+  testOperatorPrecedenceParsing();
+  testIfElseExpression();
+  testTailCallDetection();
+  testFunctionLiteralParsing();
+  testImportExpressionParsing();
   std::cout << "Unit Tests Passed!" << '\n';
   std::cout << "Hello! Welcome to the Monkey Programming Language REPL."
             << '\n';
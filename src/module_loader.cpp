@@ -0,0 +1,343 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ast.h"
+#include "lexer.h"
+#include "module_loader.h"
+#include "parser.h"
+
+static void collectImports(const Statement *statement,
+                           std::vector<std::string_view> &imports);
+
+static void collectImports(const BlockStatement *block,
+                           std::vector<std::string_view> &imports) {
+  if (block) {
+    for (const auto &statement : block->statements) {
+      collectImports(statement.get(), imports);
+    }
+  }
+}
+
+static void collectImports(const Expression *expression,
+                           std::vector<std::string_view> &imports) {
+  if (auto *importExpression =
+          dynamic_cast<const ImportExpression *>(expression)) {
+    imports.push_back(importExpression->path);
+  } else if (auto *prefix =
+                 dynamic_cast<const PrefixExpression *>(expression)) {
+    collectImports(prefix->right.get(), imports);
+  } else if (auto *infix = dynamic_cast<const InfixExpression *>(expression)) {
+    collectImports(infix->left.get(), imports);
+    collectImports(infix->right.get(), imports);
+  } else if (auto *ifExpression =
+                 dynamic_cast<const IfExpression *>(expression)) {
+    collectImports(ifExpression->condition.get(), imports);
+    collectImports(ifExpression->consequence.get(), imports);
+    collectImports(ifExpression->alternative.get(), imports);
+  } else if (auto *function =
+                 dynamic_cast<const FunctionLiteral *>(expression)) {
+    collectImports(function->body.get(), imports);
+  } else if (auto *call = dynamic_cast<const CallExpression *>(expression)) {
+    collectImports(call->function.get(), imports);
+    for (const auto &argument : call->arguments) {
+      collectImports(argument.get(), imports);
+    }
+  }
+}
+
+static void collectImports(const Statement *statement,
+                           std::vector<std::string_view> &imports) {
+  if (auto *let = dynamic_cast<const LetStatement *>(statement)) {
+    collectImports(let->value.get(), imports);
+  } else if (auto *ret = dynamic_cast<const ReturnStatement *>(statement)) {
+    collectImports(ret->returnValue.get(), imports);
+  } else if (auto *expression =
+                 dynamic_cast<const ExpressionStatement *>(statement)) {
+    collectImports(expression->expression.get(), imports);
+  }
+}
+
+static std::string normalize(const std::filesystem::path &path) {
+  return path.lexically_normal().generic_string();
+}
+
+std::optional<std::string> readModuleFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::nullopt;
+  }
+  std::stringstream SS;
+  SS << file.rdbuf();
+  return SS.str();
+}
+
+ModuleLoader::ModuleLoader(ModuleReader reader, size_t threads)
+    : m_reader(std::move(reader)) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  for (size_t i = 0; i < std::max<size_t>(threads, 1); i++) {
+    m_workers.emplace_back([this]() { work(); });
+  }
+}
+
+ModuleLoader::~ModuleLoader() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_ready.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+}
+
+void ModuleLoader::work() {
+  while (true) {
+    std::function<void()> job{};
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_ready.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+      // drain what was queued before shutting down
+      if (m_jobs.empty()) {
+        return;
+      }
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    job();
+  }
+}
+
+ModuleLoader::ModuleFuture ModuleLoader::parse(const std::string &path) {
+  auto cached = m_modules.find(path);
+  if (cached != m_modules.end()) {
+    return cached->second;
+  }
+
+  auto task = std::make_shared<
+      std::packaged_task<std::shared_ptr<const Module>()>>(
+      [reader = m_reader, path]() {
+        auto module = std::make_shared<Module>();
+        module->path = path;
+
+        std::optional<std::string> source = reader(path);
+        if (!source) {
+          module->errors.push_back("could not read " + path + ".");
+          return std::shared_ptr<const Module>(std::move(module));
+        }
+        module->read = true;
+
+        Lexer lexer(std::move(*source));
+        Parser parser(std::move(lexer));
+        module->program = parser.parseProgram();
+        module->errors = std::move(parser.m_errors);
+
+        std::vector<std::string_view> imports{};
+        for (const auto &statement : module->program.statements) {
+          collectImports(statement.get(), imports);
+        }
+        std::filesystem::path directory =
+            std::filesystem::path(path).parent_path();
+        for (std::string_view imported : imports) {
+          module->imports.push_back(normalize(directory / imported));
+        }
+        return std::shared_ptr<const Module>(std::move(module));
+      });
+  ModuleFuture future = task->get_future().share();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back([task]() { (*task)(); });
+  }
+  m_ready.notify_one();
+
+  m_modules.emplace(path, future);
+  return future;
+}
+
+// depth first from path, appending each module after its imports. state
+// is 1 while a module's imports are being visited and 2 once it is done,
+// so meeting a 1 again means the imports loop back.
+bool ModuleLoader::sort(
+    const std::string &path,
+    std::map<std::string, std::shared_ptr<const Module>> &graph,
+    std::map<std::string, int> &state, std::vector<std::string> &stack,
+    std::vector<std::shared_ptr<const Module>> &order) {
+  if (state[path] == 2) {
+    return true;
+  }
+  if (state[path] == 1) {
+    std::string cycle = "import cycle: ";
+    auto start = std::find(stack.begin(), stack.end(), path);
+    for (auto it = start; it != stack.end(); ++it) {
+      cycle += *it + " -> ";
+    }
+    m_errors.push_back(cycle + path + ".");
+    return false;
+  }
+
+  state[path] = 1;
+  stack.push_back(path);
+  for (const auto &imported : graph[path]->imports) {
+    if (!sort(imported, graph, state, stack, order)) {
+      return false;
+    }
+  }
+  stack.pop_back();
+  state[path] = 2;
+  order.push_back(graph[path]);
+  return true;
+}
+
+std::vector<std::shared_ptr<const Module>>
+ModuleLoader::load(const std::string &path) {
+  m_errors.clear();
+  std::string root = normalize(path);
+
+  // breadth first: a module's imports start parsing as soon as it has been
+  // parsed, while its siblings may still be parsing
+  std::map<std::string, std::shared_ptr<const Module>> graph{};
+  std::vector<std::string> queue{root};
+  std::map<std::string, ModuleFuture> started{{root, parse(root)}};
+  for (size_t i = 0; i < queue.size(); i++) {
+    std::shared_ptr<const Module> module = started[queue[i]].get();
+    graph[queue[i]] = module;
+    for (const auto &imported : module->imports) {
+      if (started.emplace(imported, ModuleFuture{}).second) {
+        started[imported] = parse(imported);
+        queue.push_back(imported);
+      }
+    }
+  }
+
+  bool failed = false;
+  for (const auto &[modulePath, module] : graph) {
+    // the file may exist by the next load
+    if (!module->read) {
+      m_modules.erase(modulePath);
+    }
+    for (const auto &error : module->errors) {
+      // read errors already name the file
+      m_errors.push_back(module->read ? modulePath + ": " + error : error);
+      failed = true;
+    }
+  }
+  if (failed) {
+    return {};
+  }
+
+  std::map<std::string, int> state{};
+  std::vector<std::string> stack{};
+  std::vector<std::shared_ptr<const Module>> order{};
+  if (!sort(root, graph, state, stack, order)) {
+    return {};
+  }
+  return order;
+}
+
+size_t ModuleLoader::size() const { return m_modules.size(); }
+
+size_t ModuleLoader::threads() const { return m_workers.size(); }
+
+void testModuleLoader() {
+  std::map<std::string, std::string> files{
+      {"main.mk", R"(let math = import("lib/math.mk");
+                     let strings = import("lib/strings.mk");)"},
+      {"lib/math.mk", R"(let util = import("util.mk"); let two = 2;)"},
+      {"lib/strings.mk",
+       R"(let f = fn() { import("./util.mk") }; let s = "strings";)"},
+      {"lib/util.mk", "let id = fn(x) { x };"},
+      {"a.mk", R"(import("b.mk");)"},
+      {"b.mk", R"(import("lib/../c.mk");)"},
+      {"c.mk", R"(import("a.mk");)"},
+      {"broken.mk", R"(let = 5; import("lib/util.mk");)"},
+      {"missing_import.mk", R"(import("nowhere.mk");)"},
+  };
+  auto reads = std::make_shared<std::atomic<int>>(0);
+  ModuleLoader loader([&files, reads](const std::string &path) {
+    (*reads)++;
+    auto file = files.find(path);
+    return file == files.end() ? std::nullopt
+                               : std::optional<std::string>(file->second);
+  });
+
+  auto modules = loader.load("./main.mk");
+  assert(loader.m_errors.empty() && "loading main.mk failed");
+  std::vector<std::string> paths{};
+  for (const auto &module : modules) {
+    paths.push_back(module->path);
+  }
+  // util is imported twice but parsed once, before both of its importers
+  assert(paths.size() == 4 && paths[0] == "lib/util.mk" &&
+         paths[3] == "main.mk" && "modules are not in dependency order");
+  assert(reads->load() == 4 && "a module was parsed more than once");
+  assert(modules[0]->program.statements.size() == 1 &&
+         "util.mk was not parsed");
+
+  // already parsed modules come from the cache
+  auto math = loader.load("lib/math.mk");
+  assert(math.size() == 2 && math[0] == modules[0] &&
+         "cached modules are not shared");
+  assert(reads->load() == 4 && "a cached module was parsed again");
+
+  assert(loader.load("a.mk").empty() && "import cycle was not detected");
+  assert(loader.m_errors.size() == 1 &&
+         loader.m_errors[0] == "import cycle: a.mk -> b.mk -> c.mk -> a.mk." &&
+         "import cycle is not reported");
+
+  // each load reports only its own errors
+  assert(loader.load("broken.mk").empty() && "parse errors were not reported");
+  assert(!loader.m_errors.empty() &&
+         std::all_of(loader.m_errors.begin(), loader.m_errors.end(),
+                     [](const std::string &error) {
+                       return error.rfind("broken.mk: ", 0) == 0;
+                     }) &&
+         "parse error does not name the module");
+
+  assert(loader.load("missing_import.mk").empty() &&
+         "missing import was not reported");
+  assert(loader.m_errors.size() == 1 &&
+         loader.m_errors[0] == "could not read nowhere.mk." &&
+         "missing import is not reported");
+
+  // a file that could not be read is read again once it exists
+  files["nowhere.mk"] = "let here = 1;";
+  assert(loader.load("missing_import.mk").size() == 2 &&
+         loader.m_errors.empty() && "missing import was cached");
+
+  // a wide fan-out is parsed by the fixed workers, not a thread per module
+  std::map<std::string, std::string> wide{};
+  std::string hub{};
+  for (int i = 0; i < 200; i++) {
+    std::string name = "leaf" + std::to_string(i) + ".mk";
+    wide[name] = "let value = " + std::to_string(i) + ";";
+    hub += "import(\"" + name + "\");";
+  }
+  wide["hub.mk"] = hub;
+  ModuleLoader pooled(
+      [&wide](const std::string &path) {
+        auto file = wide.find(path);
+        return file == wide.end() ? std::nullopt
+                                  : std::optional<std::string>(file->second);
+      },
+      2);
+  assert(pooled.threads() == 2 && "loader did not use the requested workers");
+  assert(pooled.load("hub.mk").size() == 201 && pooled.m_errors.empty() &&
+         "fan-out did not load on a fixed pool");
+  assert(loader.threads() >= 1 && "default loader has no workers");
+}
@@ -0,0 +1,95 @@
+#ifndef MODULE_LOADER_H
+#define MODULE_LOADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ast.h"
+
+// A parsed source file. Never changed once loaded, so a single copy is
+// shared by every module importing it, on any thread.
+struct Module {
+  // normalized, the key other modules resolve their imports to
+  std::string path{};
+  Program program{};
+  // resolved paths of the modules this one imports, in source order
+  std::vector<std::string> imports{};
+  // why the file could not be read or parsed, empty if it was
+  std::vector<std::string> errors{};
+  // false if the reader had no source at path
+  bool read{false};
+};
+
+// Returns the source at path, nullopt if there is none. Called from the
+// loader's parse tasks, so it has to be safe to call concurrently.
+using ModuleReader =
+    std::function<std::optional<std::string>(const std::string &path)>;
+
+std::optional<std::string> readModuleFile(const std::string &path);
+
+// Loads a module and everything it imports. Each module is queued for a
+// parse as soon as the module importing it has been parsed, and a fixed
+// set of worker threads drains the queue, so independent imports are
+// parsed concurrently however many there are. Parsed modules are kept for
+// the life of the loader, and a file is parsed once however many modules
+// or load() calls import it. A file that could not be read is not kept, so
+// a later load() reads it again.
+//
+// Paths are resolved against the importing module's directory and
+// normalized lexically; links are not followed.
+class ModuleLoader {
+private:
+  using ModuleFuture = std::shared_future<std::shared_ptr<const Module>>;
+
+  ModuleReader m_reader;
+  std::map<std::string, ModuleFuture> m_modules{};
+
+  // parse jobs, shared with the workers the same way IsolatePool does
+  std::vector<std::thread> m_workers{};
+  std::deque<std::function<void()>> m_jobs{};
+  std::mutex m_mutex{};
+  std::condition_variable m_ready{};
+  bool m_stopping{false};
+
+  void work();
+  ModuleFuture parse(const std::string &path);
+  bool sort(const std::string &path,
+            std::map<std::string, std::shared_ptr<const Module>> &graph,
+            std::map<std::string, int> &state,
+            std::vector<std::string> &stack,
+            std::vector<std::shared_ptr<const Module>> &order);
+
+public:
+  // threads of 0 uses one worker per hardware thread
+  explicit ModuleLoader(ModuleReader reader = readModuleFile,
+                        size_t threads = 0);
+  ~ModuleLoader();
+  ModuleLoader(const ModuleLoader &) = delete;
+  ModuleLoader &operator=(const ModuleLoader &) = delete;
+
+  std::vector<std::string> m_errors{};
+
+  // The module at path and its imports, each after the modules it
+  // imports, so path's module comes last. Empty when a module can't be
+  // read or parsed or the imports form a cycle; m_errors says why, and
+  // only holds this call's errors. Call from one thread at a time.
+  std::vector<std::shared_ptr<const Module>> load(const std::string &path);
+  // modules parsed so far
+  size_t size() const;
+  // worker threads parsing modules
+  size_t threads() const;
+};
+
+void testModuleLoader();
+
+#endif // MODULE_LOADER_H
@@ -1,9 +1,10 @@
 #include <cassert>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
-#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "ast.h"
@@ -11,7 +12,8 @@
 #include "parser.h"
 #include "token.h"
 
-Parser::Parser(Lexer lexer) : m_lexer(lexer), m_curToken(), m_peekToken() {
+Parser::Parser(Lexer lexer)
+    : m_lexer(std::move(lexer)), m_curToken(), m_peekToken() {
   nextToken();
   nextToken();
 
@@ -20,23 +22,178 @@ Parser::Parser(Lexer lexer) : m_lexer(lexer), m_curToken(), m_peekToken() {
 
   registerPrefix(token_type::integer,
                  [this]() { return parseIntegerLiteral(); });
+
+  registerPrefix(token_type::true_T, [this]() { return parseBoolean(); });
+  registerPrefix(token_type::false_T, [this]() { return parseBoolean(); });
+  registerPrefix(token_type::bang,
+                 [this]() { return parsePrefixExpression(); });
+  registerPrefix(token_type::minus,
+                 [this]() { return parsePrefixExpression(); });
+  registerPrefix(token_type::lparen,
+                 [this]() { return parseGroupedExpression(); });
+  registerPrefix(token_type::if_T, [this]() { return parseIfExpression(); });
+  registerPrefix(token_type::function,
+                 [this]() { return parseFunctionLiteral(); });
+  registerPrefix(token_type::string_T,
+                 [this]() { return parseStringLiteral(); });
+  registerPrefix(token_type::import_T,
+                 [this]() { return parseImportExpression(); });
+
+  for (token_type t :
+       {token_type::plus, token_type::minus, token_type::slash,
+        token_type::asterisk, token_type::equal, token_type::not_equal,
+        token_type::lt, token_type::gt}) {
+    registerInfix(t, [this](std::unique_ptr<Expression> left) {
+      return parseInfixExpression(std::move(left));
+    });
+  }
+
+  registerInfix(token_type::lparen,
+                [this](std::unique_ptr<Expression> function) {
+                  return parseCallExpression(std::move(function));
+                });
 };
 
 std::unique_ptr<Expression> Parser::parseIdentifier() {
   return std::make_unique<Identifier>(m_curToken, m_curToken.literal);
 };
 
+std::unique_ptr<Expression> Parser::parseBoolean() {
+  return std::make_unique<Boolean>(m_curToken,
+                                   m_curToken.type == token_type::true_T);
+}
+
+std::unique_ptr<Expression> Parser::parsePrefixExpression() {
+  Token token = m_curToken;
+  nextToken();
+  return std::make_unique<PrefixExpression>(
+      token, parseExpression(precedence::PREFIX));
+}
+
+std::unique_ptr<Expression>
+Parser::parseInfixExpression(std::unique_ptr<Expression> left) {
+  Token token = m_curToken;
+  precedence precedence = curPrecedence();
+  nextToken();
+  return std::make_unique<InfixExpression>(token, std::move(left),
+                                           parseExpression(precedence));
+}
+
+std::unique_ptr<Expression> Parser::parseGroupedExpression() {
+  nextToken();
+  auto expression = parseExpression(precedence::LOWEST);
+  if (!expectPeek(token_type::rparen)) {
+    return nullptr;
+  }
+  return expression;
+}
+
+std::unique_ptr<Expression> Parser::parseIfExpression() {
+  auto expression = std::make_unique<IfExpression>();
+  expression->token = m_curToken;
+
+  if (!expectPeek(token_type::lparen)) {
+    return nullptr;
+  }
+  nextToken();
+  expression->condition = parseExpression(precedence::LOWEST);
+
+  if (!expectPeek(token_type::rparen) || !expectPeek(token_type::lsquirly)) {
+    return nullptr;
+  }
+  expression->consequence = parseBlockStatement();
+
+  if (m_peekToken.type == token_type::else_T) {
+    nextToken();
+    if (!expectPeek(token_type::lsquirly)) {
+      return nullptr;
+    }
+    expression->alternative = parseBlockStatement();
+  }
+  return expression;
+}
+
+std::unique_ptr<Expression> Parser::parseFunctionLiteral() {
+  auto function = std::make_unique<FunctionLiteral>();
+  function->token = m_curToken;
+
+  if (!expectPeek(token_type::lparen)) {
+    return nullptr;
+  }
+  if (!parseFunctionParameters(function->parameters) ||
+      !expectPeek(token_type::lsquirly)) {
+    return nullptr;
+  }
+  function->body = parseBlockStatement();
+  return function;
+}
+
+bool Parser::parseFunctionParameters(
+    std::vector<std::unique_ptr<Identifier>> &parameters) {
+  if (m_peekToken.type == token_type::rparen) {
+    nextToken();
+    return true;
+  }
+
+  do {
+    if (!parameters.empty()) {
+      nextToken();
+    }
+    if (!expectPeek(token_type::identifier)) {
+      return false;
+    }
+    parameters.push_back(
+        std::make_unique<Identifier>(m_curToken, m_curToken.literal));
+  } while (m_peekToken.type == token_type::comma);
+
+  return expectPeek(token_type::rparen);
+}
+
+std::unique_ptr<Expression> Parser::parseStringLiteral() {
+  return std::make_unique<StringLiteral>(m_curToken, m_curToken.literal);
+}
+
+std::unique_ptr<Expression> Parser::parseImportExpression() {
+  auto expression = std::make_unique<ImportExpression>();
+  expression->token = m_curToken;
+
+  if (!expectPeek(token_type::lparen) || !expectPeek(token_type::string_T)) {
+    return nullptr;
+  }
+  expression->path = m_curToken.literal;
+
+  if (!expectPeek(token_type::rparen)) {
+    return nullptr;
+  }
+  return expression;
+}
+
+std::unique_ptr<BlockStatement> Parser::parseBlockStatement() {
+  auto block = std::make_unique<BlockStatement>();
+  block->token = m_curToken;
+  nextToken();
+
+  while (m_curToken.type != token_type::rsquirly &&
+         m_curToken.type != token_type::eof) {
+    auto statement = parseStatement();
+    if (statement) {
+      block->statements.push_back(std::move(statement));
+    }
+    nextToken();
+  }
+  return block;
+}
+
 std::unique_ptr<Expression> Parser::parseIntegerLiteral() {
-  try {
-    int value = std::stoi(m_curToken.literal);
-    auto literal = std::unique_ptr<IntegerLiteral>(
-        std::make_unique<IntegerLiteral>(m_curToken, value));
-    return literal;
-  } catch (const std::invalid_argument &) {
-    std::string Error("Could not parse " + m_curToken.literal + " as integer.");
+  // int64_t unless the literal does not fit, then a bignum
+  std::optional<Integer> value = Integer::parse(m_curToken.literal);
+  if (!value) {
+    std::string Error("Could not parse " + std::string(m_curToken.literal) +
+                      " as integer.");
     m_errors.push_back(std::move(Error));
     return nullptr;
   }
+  return std::make_unique<IntegerLiteral>(m_curToken, std::move(*value));
 }
 
 void Parser::registerPrefix(token_type t, prefixParseFn fn) {
@@ -48,15 +205,24 @@ void Parser::registerInfix(token_type t, infixParseFn fn) {
 }
 
 void Parser::nextToken() {
-  m_curToken = m_peekToken;
+  m_curToken = std::move(m_peekToken);
   m_peekToken = m_lexer.nextToken();
 }
 
 void Parser::peekError(token_type t) {
   std::ostringstream oss;
+  SourceLocation loc = m_lexer.location(m_peekToken.offset);
   oss << "expected next token to be " << t << ", got " << m_peekToken.type
-      << " instead.";
-  m_errors.push_back(oss.str().c_str());
+      << " instead at " << loc.line << ":" << loc.column << ".";
+  m_errors.push_back(oss.str());
+}
+
+void Parser::noPrefixParseFnError(token_type t) {
+  std::ostringstream oss;
+  SourceLocation loc = m_lexer.location(m_curToken.offset);
+  oss << "no prefix parse function for " << t << " found at " << loc.line
+      << ":" << loc.column << ".";
+  m_errors.push_back(oss.str());
 }
 
 bool Parser::expectPeek(token_type t) {
@@ -79,16 +245,64 @@ std::unique_ptr<ExpressionStatement> Parser::parseExpressionStatement() {
   return ES;
 }
 
-std::unique_ptr<Expression> Parser::parseExpression(precedence psrecedence) {
+precedence Parser::curPrecedence() const {
+  return precedenceOf(m_curToken.type);
+}
+
+precedence Parser::peekPrecedence() const {
+  return precedenceOf(m_peekToken.type);
+}
+
+std::unique_ptr<Expression> Parser::parseExpression(precedence precedence) {
   auto prefix = prefixParseFns.find(m_curToken.type);
-  std::cout << '\n' << m_curToken.type << '\n';
   if (prefix == prefixParseFns.end()) {
+    noPrefixParseFnError(m_curToken.type);
     return nullptr;
   }
   auto leftExp = prefix->second();
+
+  while (m_peekToken.type != token_type::semicolon &&
+         precedence < peekPrecedence()) {
+    auto infix = infixParseFns.find(m_peekToken.type);
+    if (infix == infixParseFns.end()) {
+      return leftExp;
+    }
+    nextToken();
+    leftExp = infix->second(std::move(leftExp));
+  }
   return leftExp;
 }
 
+std::unique_ptr<Expression>
+Parser::parseCallExpression(std::unique_ptr<Expression> function) {
+  auto call = std::make_unique<CallExpression>(m_curToken, std::move(function));
+  call->arguments = parseCallArguments();
+  return call;
+}
+
+std::vector<std::unique_ptr<Expression>> Parser::parseCallArguments() {
+  std::vector<std::unique_ptr<Expression>> arguments{};
+
+  if (m_peekToken.type == token_type::rparen) {
+    nextToken();
+    return arguments;
+  }
+
+  nextToken();
+  arguments.push_back(parseExpression(precedence::LOWEST));
+
+  while (m_peekToken.type == token_type::comma) {
+    nextToken();
+    nextToken();
+    arguments.push_back(parseExpression(precedence::LOWEST));
+  }
+
+  // the error is recorded, keep what was parsed
+  expectPeek(token_type::rparen);
+
+  return arguments;
+}
+
 std::unique_ptr<Statement> Parser::parseLetStatement() {
   std::unique_ptr<LetStatement> statement = std::make_unique<LetStatement>();
 
@@ -108,10 +322,11 @@ std::unique_ptr<Statement> Parser::parseLetStatement() {
     return nullptr;
   }
 
-  // TODO: Skipping the expression until we find a semicolon
-  while (m_curToken.type != token_type::semicolon) {
+  nextToken();
+  statement->value = parseExpression(precedence::LOWEST);
+
+  if (m_peekToken.type == token_type::semicolon)
     nextToken();
-  }
 
   return statement;
 }
@@ -122,11 +337,18 @@ std::unique_ptr<Statement> Parser::parseReturnStatement() {
 
   statement->token = m_curToken;
 
-  // TODO: Skipping the expression until we find a semicolon
-  while (m_curToken.type != token_type::semicolon) {
-    nextToken();
+  nextToken();
+
+  // a bare `return;` has no value
+  if (m_curToken.type == token_type::semicolon) {
+    return statement;
   }
 
+  statement->returnValue = parseExpression(precedence::LOWEST);
+
+  if (m_peekToken.type == token_type::semicolon)
+    nextToken();
+
   return statement;
 }
 
@@ -143,6 +365,7 @@ std::unique_ptr<Statement> Parser::parseStatement() {
 
 Program Parser::parseProgram() {
   Program program{};
+  program.pool = m_lexer.pool();
 
   while (m_curToken.type != token_type::eof) {
     auto statement = parseStatement();
@@ -187,6 +410,7 @@ void testLetStatements() {
          "program.statements does not equal 3");
 
   std::vector<std::string> tests{"x", "y", "foobar"};
+  std::vector<std::string> values{"5", "10", "838383"};
 
   for (int i = 0; i < tests.size(); i++) {
     auto *letStatement =
@@ -196,6 +420,8 @@ void testLetStatements() {
            "dynamic_cast to LetStatement failed, letStatement is a nullptr");
 
     testLetStatement(letStatement, tests[i]);
+    assert(letStatement->value && letStatement->value->string() == values[i] &&
+           "let statement value is not correct");
   }
 };
 
@@ -228,7 +454,7 @@ void testReturnStatements() {
   }
 };
 
-void checkParserErrors(Parser p) {
+void checkParserErrors(const Parser &p) {
   int numErrors = p.m_errors.size();
   if (numErrors == 0) {
     return;
@@ -293,3 +519,293 @@ void testIntegerLiteralExpression() {
   assert(literal->TokenLiteral() == "5" &&
          "identifier's token literal is not 5");
 }
+
+void testLargeIntegerLiteralExpression() {
+  std::string input = "9223372036854775807;"
+                      "9223372036854775808;";
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program(parser.parseProgram());
+
+  checkParserErrors(parser);
+
+  assert(program.statements.size() == 2 &&
+         "testLargeIntegerLiteralExpression: program doesn't have the correct "
+         "num of statements");
+
+  std::vector<std::string> tests{"9223372036854775807", "9223372036854775808"};
+
+  for (size_t i = 0; i < tests.size(); i++) {
+    auto *statement =
+        dynamic_cast<ExpressionStatement *>(program.statements[i].get());
+
+    assert(statement && "expression is not a statement");
+
+    [[maybe_unused]] auto *literal =
+        dynamic_cast<IntegerLiteral *>(statement->expression.get());
+
+    assert(literal && "expresstion not Integer Literal");
+    assert(literal->string() == tests[i] &&
+           "integer literal does not print its value");
+  }
+}
+
+void testCallExpressionParsing() {
+  std::string input = "add(1, foo, bar(2));";
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program(parser.parseProgram());
+
+  checkParserErrors(parser);
+
+  assert(program.statements.size() == 1 &&
+         "testCallExpressionParsing: program doesn't have the correct num of "
+         "statements");
+
+  auto *statement =
+      dynamic_cast<ExpressionStatement *>(program.statements[0].get());
+
+  assert(statement && "expression is not a statement");
+
+  [[maybe_unused]] auto *call =
+      dynamic_cast<CallExpression *>(statement->expression.get());
+
+  assert(call && "expression is not a CallExpression");
+  assert(call->function->string() == "add" && "call function is not add");
+  assert(call->arguments.size() == 3 && "call does not have 3 arguments");
+  assert(call->string() == "add(1, foo, bar(2))" &&
+         "call expression does not print its arguments");
+}
+
+void testTailCallDetection() {
+  std::string input = "return fact(n, acc);"
+                      "return acc;"
+                      "return f(x)(y);"
+                      "return;";
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program(parser.parseProgram());
+
+  checkParserErrors(parser);
+
+  assert(program.statements.size() == 4 &&
+         "testTailCallDetection: program doesn't have the correct num of "
+         "statements");
+
+  std::vector<bool> tests{true, false, true, false};
+
+  for (size_t i = 0; i < tests.size(); i++) {
+    [[maybe_unused]] auto *returnStatement =
+        dynamic_cast<ReturnStatement *>(program.statements[i].get());
+
+    assert(returnStatement && "statement is not a ReturnStatement");
+    assert(returnStatement->isTailCall() == tests[i] &&
+           "tail call detected incorrectly");
+  }
+
+  assert(program.string() == "return fact(n, acc);return acc;"
+                             "return f(x)(y);return ;" &&
+         "return values do not print");
+}
+
+void testPrefixExpressions() {
+  struct PrefixTest {
+    std::string input;
+    std::string op;
+    std::string right;
+  };
+
+  std::vector<PrefixTest> tests{
+      {"!5;", "!", "5"},
+      {"-15;", "-", "15"},
+      {"!true;", "!", "true"},
+  };
+
+  for (const auto &test : tests) {
+    Lexer lexer(test.input);
+    Parser parser(lexer);
+    Program program(parser.parseProgram());
+
+    checkParserErrors(parser);
+
+    assert(program.statements.size() == 1 &&
+           "testPrefixExpressions: program doesn't have the correct num of "
+           "statements");
+
+    auto *statement =
+        dynamic_cast<ExpressionStatement *>(program.statements[0].get());
+
+    assert(statement && "expression is not a statement");
+
+    [[maybe_unused]] auto *prefix =
+        dynamic_cast<PrefixExpression *>(statement->expression.get());
+
+    assert(prefix && "expression is not a PrefixExpression");
+    assert(prefix->op == test.op && "prefix operator is wrong");
+    assert(prefix->right->string() == test.right && "prefix operand is wrong");
+  }
+}
+
+void testOperatorPrecedenceParsing() {
+  std::vector<std::pair<std::string, std::string>> tests{
+      {"-a * b", "((-a) * b)"},
+      {"!-a", "(!(-a))"},
+      {"a + b + c", "((a + b) + c)"},
+      {"a + b * c + d / e - f", "(((a + (b * c)) + (d / e)) - f)"},
+      {"5 > 4 == 3 < 4", "((5 > 4) == (3 < 4))"},
+      {"3 + 4 * 5 == 3 * 1 + 4 * 5", "((3 + (4 * 5)) == ((3 * 1) + (4 * 5)))"},
+      {"true != !false", "(true != (!false))"},
+      {"(5 + 5) * 2", "((5 + 5) * 2)"},
+      {"-(5 + 5)", "(-(5 + 5))"},
+      {"a + add(b * c) + d", "((a + add((b * c))) + d)"},
+      {"x * 2 + y > 10", "(((x * 2) + y) > 10)"},
+  };
+
+  for (const auto &[input, expected] : tests) {
+    Lexer lexer(input);
+    Parser parser(lexer);
+    Program program(parser.parseProgram());
+
+    checkParserErrors(parser);
+
+    assert(program.string() == expected &&
+           "operator precedence parsed incorrectly");
+  }
+}
+
+void testIfElseExpression() {
+  std::string input = "if (x < y) { x } else { y; z }";
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program(parser.parseProgram());
+
+  checkParserErrors(parser);
+
+  assert(program.statements.size() == 1 &&
+         "testIfElseExpression: program doesn't have the correct num of "
+         "statements");
+
+  auto *statement =
+      dynamic_cast<ExpressionStatement *>(program.statements[0].get());
+
+  assert(statement && "expression is not a statement");
+
+  [[maybe_unused]] auto *ifExpression =
+      dynamic_cast<IfExpression *>(statement->expression.get());
+
+  assert(ifExpression && "expression is not an IfExpression");
+  assert(ifExpression->condition->string() == "(x < y)" &&
+         "if condition is wrong");
+  assert(ifExpression->consequence->statements.size() == 1 &&
+         "consequence does not have 1 statement");
+  assert(ifExpression->alternative &&
+         ifExpression->alternative->statements.size() == 2 &&
+         "alternative does not have 2 statements");
+  assert(program.string() == "if ((x < y)) { x; } else { y; z; }" &&
+         "if expression does not print its blocks");
+}
+
+void testFunctionLiteralParsing() {
+  std::string input = "let add = fn(x, y) { x + y; };";
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program(parser.parseProgram());
+
+  checkParserErrors(parser);
+
+  assert(program.statements.size() == 1 &&
+         "testFunctionLiteralParsing: program doesn't have 1 statement");
+
+  auto *let = dynamic_cast<LetStatement *>(program.statements[0].get());
+  assert(let && "statement is not a LetStatement");
+
+  [[maybe_unused]] auto *function =
+      dynamic_cast<FunctionLiteral *>(let->value.get());
+  assert(function && "let value is not a FunctionLiteral");
+  assert(function->parameters.size() == 2 &&
+         function->parameters[0]->value == "x" &&
+         function->parameters[1]->value == "y" &&
+         "function parameters are wrong");
+  assert(function->body->statements.size() == 1 &&
+         "function body doesn't have 1 statement");
+  assert(program.string() == "let add = fn(x, y) { (x + y); };" &&
+         "function literal does not print");
+
+  struct ParameterTest {
+    std::string input;
+    std::vector<std::string> parameters;
+  };
+
+  std::vector<ParameterTest> tests{
+      {"fn() {};", {}},
+      {"fn(x) {};", {"x"}},
+      {"fn(x, y, z) {};", {"x", "y", "z"}},
+  };
+
+  for (const auto &test : tests) {
+    Lexer lexer(test.input);
+    Parser parser(lexer);
+    Program program(parser.parseProgram());
+    checkParserErrors(parser);
+
+    auto *statement =
+        dynamic_cast<ExpressionStatement *>(program.statements[0].get());
+    [[maybe_unused]] auto *function =
+        dynamic_cast<FunctionLiteral *>(statement->expression.get());
+    assert(function && "expression is not a FunctionLiteral");
+    assert(function->parameters.size() == test.parameters.size() &&
+           "wrong number of function parameters");
+    for (size_t i = 0; i < test.parameters.size(); i++) {
+      assert(function->parameters[i]->value == test.parameters[i] &&
+             "function parameter is wrong");
+    }
+  }
+
+  for (std::string input : {"fn(x, ) {}", "fn(1) {}", "fn(x y) {}"}) {
+    Lexer lexer(input);
+    Parser parser(lexer);
+    parser.parseProgram();
+    assert(!parser.m_errors.empty() && "bad parameter list parsed");
+  }
+}
+
+void testImportExpressionParsing() {
+  std::string input = R"(let math = import("lib/math.mk"); "hello";)";
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program(parser.parseProgram());
+
+  checkParserErrors(parser);
+
+  assert(program.statements.size() == 2 &&
+         "testImportExpressionParsing: program doesn't have 2 statements");
+
+  auto *let = dynamic_cast<LetStatement *>(program.statements[0].get());
+  [[maybe_unused]] auto *importExpression =
+      dynamic_cast<ImportExpression *>(let->value.get());
+  assert(importExpression && "let value is not an ImportExpression");
+  assert(importExpression->path == "lib/math.mk" && "import path is wrong");
+
+  auto *statement =
+      dynamic_cast<ExpressionStatement *>(program.statements[1].get());
+  [[maybe_unused]] auto *string =
+      dynamic_cast<StringLiteral *>(statement->expression.get());
+  assert(string && string->value == "hello" &&
+         "expression is not the string literal");
+
+  assert(program.string() == R"(let math = import("lib/math.mk");"hello")" &&
+         "import and string literals do not print");
+
+  for (std::string bad : {"import(math)", "import(\"a\"", "import \"a\""}) {
+    Lexer lexer(bad);
+    Parser parser(lexer);
+    parser.parseProgram();
+    assert(!parser.m_errors.empty() && "bad import parsed");
+  }
+}
@@ -5,6 +5,7 @@
 #include "lexer.h"
 #include "token.h"
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,12 +18,35 @@ enum precedence {
   INDEX,
   LOWEST,
   EQUALS,
+  LESSGREATER,
   SUM,
   PRODUCT,
   PREFIX,
   CALL,
 };
 
+// binding power of each infix token, anything missing is LOWEST
+constexpr precedence precedenceOf(token_type type) {
+  switch (type) {
+  case token_type::equal:
+  case token_type::not_equal:
+    return precedence::EQUALS;
+  case token_type::lt:
+  case token_type::gt:
+    return precedence::LESSGREATER;
+  case token_type::plus:
+  case token_type::minus:
+    return precedence::SUM;
+  case token_type::slash:
+  case token_type::asterisk:
+    return precedence::PRODUCT;
+  case token_type::lparen:
+    return precedence::CALL;
+  default:
+    return precedence::LOWEST;
+  }
+}
+
 class Parser {
 private:
   Lexer m_lexer;
@@ -32,6 +56,13 @@ private:
   std::unique_ptr<Statement> parseLetStatement();
   std::unique_ptr<Statement> parseReturnStatement();
   std::unique_ptr<ExpressionStatement> parseExpressionStatement();
+  std::vector<std::unique_ptr<Expression>> parseCallArguments();
+  std::unique_ptr<BlockStatement> parseBlockStatement();
+  bool parseFunctionParameters(
+      std::vector<std::unique_ptr<Identifier>> &parameters);
+  precedence peekPrecedence() const;
+  precedence curPrecedence() const;
+  void noPrefixParseFnError(token_type t);
 
 public:
   std::vector<std::string> m_errors{};
@@ -46,16 +77,34 @@ public:
   std::unique_ptr<Expression> parseExpression(precedence precedence);
   std::unique_ptr<Expression> parseIntegerLiteral();
   std::unique_ptr<Expression> parseIdentifier();
+  std::unique_ptr<Expression> parseBoolean();
+  std::unique_ptr<Expression> parsePrefixExpression();
+  std::unique_ptr<Expression> parseInfixExpression(std::unique_ptr<Expression> left);
+  std::unique_ptr<Expression> parseGroupedExpression();
+  std::unique_ptr<Expression> parseIfExpression();
+  std::unique_ptr<Expression> parseFunctionLiteral();
+  std::unique_ptr<Expression> parseStringLiteral();
+  std::unique_ptr<Expression> parseImportExpression();
+  std::unique_ptr<Expression>
+  parseCallExpression(std::unique_ptr<Expression> function);
 
   std::map<token_type, prefixParseFn> prefixParseFns;
   std::map<token_type, infixParseFn> infixParseFns;
 };
 
-void checkParserErrors(Parser P);
+void checkParserErrors(const Parser &p);
 void testLetStatements();
 void testReturnStatements();
 void testLetStatement(Statement *statement, std::string &name);
 void testIdentifierExpression();
 void testIntegerLiteralExpression();
+void testLargeIntegerLiteralExpression();
+void testCallExpressionParsing();
+void testPrefixExpressions();
+void testOperatorPrecedenceParsing();
+void testIfElseExpression();
+void testTailCallDetection();
+void testFunctionLiteralParsing();
+void testImportExpressionParsing();
 
 #endif // !PARSER_H
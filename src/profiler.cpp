@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "column_kernel.h"
+#include "lexer.h"
+#include "parser.h"
+#include "profiler.h"
+#include "source.h"
+
+static std::string_view opName(kernel_op op) {
+  switch (op) {
+  case op_add:
+    return "+";
+  case op_subtract:
+    return "-";
+  case op_multiply:
+    return "*";
+  case op_divide:
+    return "/";
+  case op_less:
+    return "<";
+  case op_greater:
+    return ">";
+  case op_equal:
+    return "==";
+  case op_not_equal:
+    return "!=";
+  case op_negate:
+    return "neg";
+  case op_not:
+    return "!";
+  case op_select:
+    return "if";
+  default:
+    return "";
+  }
+}
+
+static std::string frame(const ColumnKernel &kernel, int node,
+                         const LineIndex &lines) {
+  const KernelNode &kernelNode = kernel.nodes()[node];
+  std::string name{};
+  if (kernelNode.op == op_column) {
+    name = kernel.columns()[kernelNode.value];
+  } else if (kernelNode.op == op_constant) {
+    name = kernelNode.isBoolean ? (kernelNode.value ? "true" : "false")
+                                : std::to_string(kernelNode.value);
+  } else {
+    name = opName(kernelNode.op);
+    if (kernelNode.literalOperand) {
+      name += std::to_string(kernelNode.value);
+    }
+  }
+  SourceLocation location = lines.locate(kernelNode.offset);
+  return name + "@" + std::to_string(location.line) + ":" +
+         std::to_string(location.column);
+}
+
+std::string kernelFrame(const ColumnKernel &kernel, int node,
+                        std::string_view source) {
+  return frame(kernel, node, LineIndex(source));
+}
+
+static void collapse(const ColumnKernel &kernel, const KernelProfile &profile,
+                     const LineIndex &lines, int node, std::string stack,
+                     std::ostringstream &out) {
+  if (node < 0 || profile.nodes[node].calls == 0) {
+    return;
+  }
+  if (!stack.empty()) {
+    stack += ';';
+  }
+  stack += frame(kernel, node, lines);
+
+  uint64_t self = profile.selfNanos(kernel.nodes(), node);
+  if (self > 0) {
+    out << stack << ' ' << self << '\n';
+  }
+
+  const KernelNode &kernelNode = kernel.nodes()[node];
+  collapse(kernel, profile, lines, kernelNode.condition, stack, out);
+  collapse(kernel, profile, lines, kernelNode.lhs, stack, out);
+  collapse(kernel, profile, lines, kernelNode.rhs, stack, out);
+}
+
+std::string collapsedStacks(const ColumnKernel &kernel,
+                            const KernelProfile &profile,
+                            std::string_view source) {
+  std::ostringstream out;
+  if (profile.nodes.size() == kernel.nodes().size()) {
+    collapse(kernel, profile, LineIndex(source), kernel.root(), "", out);
+  }
+  return out.str();
+}
+
+std::string profileTable(const ColumnKernel &kernel,
+                         const KernelProfile &profile,
+                         std::string_view source) {
+  std::ostringstream out;
+  out << "node calls rows self_ns total_ns\n";
+  if (profile.nodes.size() != kernel.nodes().size()) {
+    return out.str();
+  }
+
+  std::vector<size_t> order{};
+  for (size_t i = 0; i < profile.nodes.size(); i++) {
+    if (profile.nodes[i].calls > 0) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return profile.selfNanos(kernel.nodes(), a) >
+           profile.selfNanos(kernel.nodes(), b);
+  });
+
+  LineIndex lines(source);
+  for (size_t i : order) {
+    const KernelNodeProfile &node = profile.nodes[i];
+    out << frame(kernel, static_cast<int>(i), lines) << ' ' << node.calls
+        << ' ' << node.rows << ' ' << profile.selfNanos(kernel.nodes(), i)
+        << ' ' << node.totalNanos << '\n';
+  }
+  return out.str();
+}
+
+void testProfiler() {
+  std::string input = "if (x < y) {\n  x * 3\n} else {\n  y / 2\n}";
+  std::vector<std::string_view> names{"x", "y"};
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  auto expression = parser.parseExpression(precedence::LOWEST);
+  checkParserErrors(parser);
+  ColumnKernel kernel(*expression, names);
+  assert(kernel.m_errors.empty() && "kernel failed to compile");
+
+  std::vector<int64_t> x{};
+  std::vector<int64_t> y{};
+  for (int64_t i = 0; i < 5000; i++) {
+    x.push_back(i % 7);
+    y.push_back(i % 5);
+  }
+  std::vector<std::span<const int64_t>> columns{x, y};
+  std::vector<int64_t> output(x.size());
+
+  KernelProfile profile{};
+  profile.sampleEvery = 2;
+  KernelScratch scratch{};
+  scratch.profile = &profile;
+  kernel.run(columns, output, scratch);
+
+  // 5 batches, the 1st, 3rd and 5th of which are timed
+  [[maybe_unused]] const KernelNodeProfile &root =
+      profile.nodes[kernel.root()];
+  assert(profile.batches == 5 && "profile missed batches");
+  assert(root.calls == 3 && "profile timed the wrong number of batches");
+  assert(root.rows == 2 * ColumnKernel::batchSize + 5000 % 1024 &&
+         "profile counted the wrong number of rows");
+
+  [[maybe_unused]] const KernelNode &select = kernel.nodes()[kernel.root()];
+  assert(profile.nodes[select.lhs].rows + profile.nodes[select.rhs].rows ==
+             root.rows &&
+         "branch rows do not add up to the rows of the if");
+  assert(profile.selfNanos(kernel.nodes(), kernel.root()) <= root.totalNanos &&
+         "self time exceeds total time");
+
+  assert(kernelFrame(kernel, kernel.root(), input) == "if@1:1" &&
+         "if frame has the wrong position");
+  assert(kernelFrame(kernel, select.lhs, input) == "*3@2:5" &&
+         "multiply frame has the wrong position");
+  assert(kernelFrame(kernel, kernel.nodes()[select.rhs].lhs, input) ==
+             "y@4:3" &&
+         "column frame has the wrong position");
+
+  std::istringstream stacks(collapsedStacks(kernel, profile, input));
+  std::string line{};
+  while (std::getline(stacks, line)) {
+    assert(line.rfind("if@1:1", 0) == 0 && "stack does not start at the root");
+    [[maybe_unused]] size_t space = line.rfind(' ');
+    assert(space != std::string::npos &&
+           line.find_first_not_of("0123456789", space + 1) ==
+               std::string::npos &&
+           "stack line does not end in a count");
+  }
+
+  std::string table = profileTable(kernel, profile, input);
+  assert(table.find("if@1:1 3 " + std::to_string(root.rows)) !=
+             std::string::npos &&
+         "table is missing the if row");
+
+  // without a profile nothing is timed
+  KernelScratch plain{};
+  kernel.run(columns, output, plain);
+  assert(!plain.sampling && "unprofiled run is sampling");
+}
@@ -0,0 +1,30 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <string_view>
+
+#include "column_kernel.h"
+
+// Reports for a KernelProfile. Nodes are named by what they compute and
+// where they came from in source, the text the kernel was compiled from,
+// e.g. "<@1:12", "x@1:10", or "*2@1:3" for an operator holding its literal
+// operand.
+std::string kernelFrame(const ColumnKernel &kernel, int node,
+                        std::string_view source);
+
+// One line per node that took time, in the collapsed stack format read by
+// flamegraph.pl and speedscope: root to node frames joined by ';', then
+// the node's self time in nanoseconds.
+std::string collapsedStacks(const ColumnKernel &kernel,
+                            const KernelProfile &profile,
+                            std::string_view source);
+
+// Calls, rows, self and total time per node, hottest self time first.
+std::string profileTable(const ColumnKernel &kernel,
+                         const KernelProfile &profile,
+                         std::string_view source);
+
+void testProfiler();
+
+#endif // PROFILER_H
@@ -0,0 +1,214 @@
+#include <cassert>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "ast.h"
+#include "lexer.h"
+#include "parser.h"
+#include "purity.h"
+
+using Scope = std::set<std::string_view>;
+
+static void collectGlobals(
+    const Statement *statement, std::map<std::string_view, int> &bindings,
+    std::map<std::string_view, const FunctionLiteral *> &functions);
+
+// Lets outside any function body bind globals, including the ones inside
+// if blocks. Function bodies are left alone, their lets are locals.
+static void collectGlobals(
+    const Expression *expression, std::map<std::string_view, int> &bindings,
+    std::map<std::string_view, const FunctionLiteral *> &functions) {
+  if (auto *prefix = dynamic_cast<const PrefixExpression *>(expression)) {
+    collectGlobals(prefix->right.get(), bindings, functions);
+  } else if (auto *infix = dynamic_cast<const InfixExpression *>(expression)) {
+    collectGlobals(infix->left.get(), bindings, functions);
+    collectGlobals(infix->right.get(), bindings, functions);
+  } else if (auto *ifExpression =
+                 dynamic_cast<const IfExpression *>(expression)) {
+    collectGlobals(ifExpression->condition.get(), bindings, functions);
+    for (const BlockStatement *block :
+         {ifExpression->consequence.get(), ifExpression->alternative.get()}) {
+      if (block) {
+        for (const auto &statement : block->statements) {
+          collectGlobals(statement.get(), bindings, functions);
+        }
+      }
+    }
+  } else if (auto *call = dynamic_cast<const CallExpression *>(expression)) {
+    collectGlobals(call->function.get(), bindings, functions);
+    for (const auto &argument : call->arguments) {
+      collectGlobals(argument.get(), bindings, functions);
+    }
+  }
+}
+
+static void collectGlobals(
+    const Statement *statement, std::map<std::string_view, int> &bindings,
+    std::map<std::string_view, const FunctionLiteral *> &functions) {
+  if (auto *let = dynamic_cast<const LetStatement *>(statement)) {
+    collectGlobals(let->value.get(), bindings, functions);
+    bindings[let->name->value]++;
+    if (auto *function = dynamic_cast<const FunctionLiteral *>(let->value.get())) {
+      functions[let->name->value] = function;
+    }
+  } else if (auto *ret = dynamic_cast<const ReturnStatement *>(statement)) {
+    collectGlobals(ret->returnValue.get(), bindings, functions);
+  } else if (auto *expression =
+                 dynamic_cast<const ExpressionStatement *>(statement)) {
+    collectGlobals(expression->expression.get(), bindings, functions);
+  }
+}
+
+static bool isPure(const Statement *statement, Scope &scope,
+                   const std::set<std::string_view> &pure);
+
+static bool isPure(const BlockStatement *block, Scope &scope,
+                   const std::set<std::string_view> &pure) {
+  if (!block) {
+    return true;
+  }
+  for (const auto &statement : block->statements) {
+    if (!isPure(statement.get(), scope, pure)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool isPure(const FunctionLiteral *function, Scope scope,
+                   const std::set<std::string_view> &pure) {
+  for (const auto &parameter : function->parameters) {
+    scope.insert(parameter->value);
+  }
+  return isPure(function->body.get(), scope, pure);
+}
+
+// scope holds the parameters and locals visible at this point; blocks do
+// not open a new one in Monkey
+static bool isPure(const Expression *expression, Scope &scope,
+                   const std::set<std::string_view> &pure) {
+  if (auto *identifier = dynamic_cast<const Identifier *>(expression)) {
+    return scope.count(identifier->value) > 0 ||
+           pure.count(identifier->value) > 0;
+  }
+  if (dynamic_cast<const IntegerLiteral *>(expression) ||
+      dynamic_cast<const Boolean *>(expression)) {
+    return true;
+  }
+  if (auto *prefix = dynamic_cast<const PrefixExpression *>(expression)) {
+    return isPure(prefix->right.get(), scope, pure);
+  }
+  if (auto *infix = dynamic_cast<const InfixExpression *>(expression)) {
+    return isPure(infix->left.get(), scope, pure) &&
+           isPure(infix->right.get(), scope, pure);
+  }
+  if (auto *ifExpression = dynamic_cast<const IfExpression *>(expression)) {
+    return isPure(ifExpression->condition.get(), scope, pure) &&
+           isPure(ifExpression->consequence.get(), scope, pure) &&
+           isPure(ifExpression->alternative.get(), scope, pure);
+  }
+  if (auto *function = dynamic_cast<const FunctionLiteral *>(expression)) {
+    return isPure(function, scope, pure);
+  }
+  if (auto *call = dynamic_cast<const CallExpression *>(expression)) {
+    // a parameter or local may hold any function, so only calls that name
+    // a pure global or a literal are known to be pure
+    auto *callee = dynamic_cast<const Identifier *>(call->function.get());
+    bool knownCallee =
+        callee ? scope.count(callee->value) == 0 && pure.count(callee->value)
+               : dynamic_cast<const FunctionLiteral *>(call->function.get()) &&
+                     isPure(call->function.get(), scope, pure);
+    if (!knownCallee) {
+      return false;
+    }
+    for (const auto &argument : call->arguments) {
+      if (!isPure(argument.get(), scope, pure)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+static bool isPure(const Statement *statement, Scope &scope,
+                   const std::set<std::string_view> &pure) {
+  if (auto *let = dynamic_cast<const LetStatement *>(statement)) {
+    // the value is read before the name is bound
+    if (!isPure(let->value.get(), scope, pure)) {
+      return false;
+    }
+    scope.insert(let->name->value);
+    return true;
+  }
+  if (auto *ret = dynamic_cast<const ReturnStatement *>(statement)) {
+    return !ret->returnValue || isPure(ret->returnValue.get(), scope, pure);
+  }
+  if (auto *expression = dynamic_cast<const ExpressionStatement *>(statement)) {
+    return isPure(expression->expression.get(), scope, pure);
+  }
+  return false;
+}
+
+std::set<std::string_view> pureFunctions(const Program &program) {
+  std::map<std::string_view, int> bindings{};
+  std::map<std::string_view, const FunctionLiteral *> functions{};
+  for (const auto &statement : program.statements) {
+    collectGlobals(statement.get(), bindings, functions);
+  }
+
+  // start from every candidate and drop the ones that read something
+  // impure until nothing changes, so recursive and mutually recursive
+  // functions stay pure
+  std::set<std::string_view> pure{};
+  for (const auto &[name, function] : functions) {
+    if (bindings[name] == 1) {
+      pure.insert(name);
+    }
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = pure.begin(); it != pure.end();) {
+      if (isPure(functions[*it], Scope{}, pure)) {
+        ++it;
+      } else {
+        it = pure.erase(it);
+        changed = true;
+      }
+    }
+  }
+  return pure;
+}
+
+void testPurity() {
+  std::string input =
+      "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };"
+      "let square = fn(x) { let y = x * x; y };"
+      "let even = fn(n) { if (n == 0) { true } else { odd(n - 1) } };"
+      "let odd = fn(n) { if (n == 0) { false } else { even(n - 1) } };"
+      "let adder = fn(x) { fn(y) { x + y } };"
+      "let immediate = fn(x) { fn(y) { y * 2 }(x) };"
+      "let counter = 0;"
+      "let readsGlobal = fn(x) { x + counter };"
+      "let logs = fn(x) { puts(x); x };"
+      "let callsImpure = fn(x) { return logs(x); };"
+      "let apply = fn(f, x) { f(x) };"
+      "let shadows = fn(fib) { fib(1) };"
+      "let twice = fn(x) { x };"
+      "if (true) { let twice = fn(x) { x * 2 }; };"
+      "let usesTwice = fn(x) { twice(x) };";
+
+  Lexer lexer(input);
+  Parser parser(lexer);
+  Program program(parser.parseProgram());
+  checkParserErrors(parser);
+
+  std::set<std::string_view> pure = pureFunctions(program);
+  std::set<std::string_view> expected{"fib",   "square", "even",
+                                      "odd",   "adder",  "immediate"};
+  assert(pure == expected && "wrong set of pure functions");
+}
@@ -0,0 +1,22 @@
+#ifndef PURITY_H
+#define PURITY_H
+
+#include <set>
+#include <string_view>
+
+#include "ast.h"
+
+// Top-level functions whose result depends only on their arguments, the
+// calls a memo table keyed by argument values could answer. A function is
+// pure when every name it reads is one of its parameters, a let inside it,
+// or another pure top-level function, and it only calls pure top-level
+// functions or function literals. There are no builtins yet, so any other
+// callee is treated as having side effects.
+//
+// Top-level names bound more than once can change between calls and are
+// never pure. The returned names point into program.pool.
+std::set<std::string_view> pureFunctions(const Program &program);
+
+void testPurity();
+
+#endif // PURITY_H
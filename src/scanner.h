@@ -0,0 +1,167 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "token.h"
+
+// Where a token sits in its input. Scanning only reads the input, so the
+// same code runs in Lexer and in constant evaluation.
+struct ScannedToken {
+  token_type type;
+  uint32_t offset;
+  // bytes of input the token covers, including a string's quotes; 0 for
+  // eof at the end of the input
+  uint32_t length;
+};
+
+constexpr bool isLetter(char ch) {
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+}
+
+constexpr bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+// The fixed text of operator and keyword tokens, empty for the others.
+constexpr std::string_view tokenText(token_type type) {
+  switch (type) {
+  case token_type::assign:
+    return "=";
+  case token_type::plus:
+    return "+";
+  case token_type::minus:
+    return "-";
+  case token_type::bang:
+    return "!";
+  case token_type::slash:
+    return "/";
+  case token_type::asterisk:
+    return "*";
+  case token_type::lt:
+    return "<";
+  case token_type::gt:
+    return ">";
+  case token_type::comma:
+    return ",";
+  case token_type::semicolon:
+    return ";";
+  case token_type::lparen:
+    return "(";
+  case token_type::rparen:
+    return ")";
+  case token_type::lsquirly:
+    return "{";
+  case token_type::rsquirly:
+    return "}";
+  case token_type::equal:
+    return "==";
+  case token_type::not_equal:
+    return "!=";
+  case token_type::function:
+    return "fn";
+  case token_type::let:
+    return "let";
+  case token_type::if_T:
+    return "if";
+  case token_type::else_T:
+    return "else";
+  case token_type::return_T:
+    return "return";
+  case token_type::true_T:
+    return "true";
+  case token_type::false_T:
+    return "false";
+  case token_type::import_T:
+    return "import";
+  default:
+    return "";
+  }
+}
+
+// The token at or after position, skipping whitespace. A NUL byte ends the
+// input like its end does, but covers one byte so scanning can go past it.
+// Strings have no escapes and run to the next quote; one left unterminated
+// is illegal and covers the rest of the input.
+constexpr ScannedToken scanToken(std::string_view input, size_t position) {
+  while (position < input.size() &&
+         (input[position] == ' ' || input[position] == '\t' ||
+          input[position] == '\n' || input[position] == '\r')) {
+    position++;
+  }
+
+  const uint32_t offset = static_cast<uint32_t>(position);
+  if (position >= input.size()) {
+    return {token_type::eof, offset, 0};
+  }
+
+  const char ch = input[position];
+  const char next = position + 1 < input.size() ? input[position + 1] : 0;
+  switch (ch) {
+  case '=':
+    return next == '=' ? ScannedToken{token_type::equal, offset, 2}
+                       : ScannedToken{token_type::assign, offset, 1};
+  case '!':
+    return next == '=' ? ScannedToken{token_type::not_equal, offset, 2}
+                       : ScannedToken{token_type::bang, offset, 1};
+  case ';':
+    return {token_type::semicolon, offset, 1};
+  case '(':
+    return {token_type::lparen, offset, 1};
+  case ')':
+    return {token_type::rparen, offset, 1};
+  case ',':
+    return {token_type::comma, offset, 1};
+  case '+':
+    return {token_type::plus, offset, 1};
+  case '-':
+    return {token_type::minus, offset, 1};
+  case '{':
+    return {token_type::lsquirly, offset, 1};
+  case '}':
+    return {token_type::rsquirly, offset, 1};
+  case '<':
+    return {token_type::lt, offset, 1};
+  case '>':
+    return {token_type::gt, offset, 1};
+  case '*':
+    return {token_type::asterisk, offset, 1};
+  case '/':
+    return {token_type::slash, offset, 1};
+  case '"': {
+    size_t end = position + 1;
+    while (end < input.size() && input[end] != '"' && input[end] != 0) {
+      end++;
+    }
+    if (end < input.size() && input[end] == '"') {
+      return {token_type::string_T, offset,
+              static_cast<uint32_t>(end + 1 - position)};
+    }
+    return {token_type::illegal, offset,
+            static_cast<uint32_t>(end - position)};
+  }
+  case '\0':
+    return {token_type::eof, offset, 1};
+  default:
+    break;
+  }
+
+  size_t end = position + 1;
+  if (isLetter(ch)) {
+    // letters or an underscore start an identifier, digits may follow
+    while (end < input.size() && (isLetter(input[end]) || isDigit(input[end]))) {
+      end++;
+    }
+    std::string_view word = input.substr(position, end - position);
+    return {getKeyword(word), offset, static_cast<uint32_t>(end - position)};
+  }
+  if (isDigit(ch)) {
+    while (end < input.size() && isDigit(input[end])) {
+      end++;
+    }
+    return {token_type::integer, offset, static_cast<uint32_t>(end - position)};
+  }
+  return {token_type::illegal, offset, 1};
+}
+
+#endif // SCANNER_H
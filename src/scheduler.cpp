@@ -0,0 +1,238 @@
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "column_kernel.h"
+#include "lexer.h"
+#include "parser.h"
+#include "scheduler.h"
+
+// Kernel Task
+KernelTask KernelTask::promise_type::get_return_object() {
+  return KernelTask(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+void KernelTask::promise_type::unhandled_exception() { std::terminate(); }
+
+KernelTask::KernelTask(std::coroutine_handle<promise_type> handle)
+    : m_handle(handle) {}
+
+KernelTask::KernelTask(KernelTask &&other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+KernelTask &KernelTask::operator=(KernelTask &&other) noexcept {
+  if (this != &other) {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+    m_handle = std::exchange(other.m_handle, nullptr);
+  }
+  return *this;
+}
+
+KernelTask::~KernelTask() {
+  if (m_handle) {
+    m_handle.destroy();
+  }
+}
+
+task_status KernelTask::resume() {
+  if (m_handle && !m_handle.done()) {
+    m_handle.resume();
+  }
+  return result().status;
+}
+
+KernelTaskResult KernelTask::result() const {
+  if (!m_handle) {
+    return KernelTaskResult{task_finished, false};
+  }
+  return m_handle.promise().result;
+}
+
+KernelTask runKernelTask(std::shared_ptr<const ColumnKernel> kernel,
+                         std::vector<std::span<const int64_t>> columns,
+                         std::span<int64_t> output, size_t sliceBatches,
+                         size_t quotaBatches) {
+  KernelScratch scratch{};
+  if (!kernel->prepare(columns, output.size(), scratch)) {
+    co_return KernelTaskResult{task_finished, false};
+  }
+
+  size_t batches = 0;
+  for (size_t start = 0; start < output.size();
+       start += ColumnKernel::batchSize) {
+    if (quotaBatches > 0 && batches == quotaBatches) {
+      co_return KernelTaskResult{task_over_quota, !scratch.divisionByZero};
+    }
+    kernel->runBatch(output, start, scratch);
+    batches++;
+
+    bool more = start + ColumnKernel::batchSize < output.size();
+    if (more && sliceBatches > 0 && batches % sliceBatches == 0) {
+      co_await std::suspend_always{};
+    }
+  }
+  co_return KernelTaskResult{task_finished, !scratch.divisionByZero};
+}
+
+// Scheduler
+TaskId Scheduler::spawn(KernelTask task) {
+  uint32_t index = 0;
+  if (m_free.empty()) {
+    index = static_cast<uint32_t>(m_slots.size());
+    m_slots.emplace_back();
+  } else {
+    index = m_free.back();
+    m_free.pop_back();
+  }
+
+  Slot &slot = m_slots[index];
+  slot.task.emplace(std::move(task));
+  slot.result = slot.task->result();
+  slot.live = true;
+  return TaskId{index, slot.generation};
+}
+
+size_t Scheduler::step() {
+  size_t running = 0;
+  for (auto &slot : m_slots) {
+    if (!slot.task) {
+      continue;
+    }
+    if (slot.task->resume() == task_running) {
+      running++;
+      continue;
+    }
+    slot.result = slot.task->result();
+    slot.task.reset();
+  }
+  return running;
+}
+
+void Scheduler::run() {
+  while (step() > 0) {
+  }
+}
+
+bool Scheduler::contains(TaskId id) const {
+  return id.index < m_slots.size() && m_slots[id.index].live &&
+         m_slots[id.index].generation == id.generation;
+}
+
+std::optional<KernelTaskResult> Scheduler::result(TaskId id) const {
+  if (!contains(id)) {
+    return std::nullopt;
+  }
+  return m_slots[id.index].result;
+}
+
+bool Scheduler::release(TaskId id) {
+  if (!contains(id) || m_slots[id.index].task) {
+    return false;
+  }
+  Slot &slot = m_slots[id.index];
+  slot.live = false;
+  slot.generation++;
+  m_free.push_back(id.index);
+  return true;
+}
+
+size_t Scheduler::size() const { return m_slots.size() - m_free.size(); }
+
+void testScheduler() {
+  std::vector<std::string_view> names{"x"};
+  Lexer lexer("if (x > 0) { 100 / x } else { x * x }");
+  Parser parser(lexer);
+  auto expression = parser.parseExpression(precedence::LOWEST);
+  checkParserErrors(parser);
+  auto kernel = std::make_shared<const ColumnKernel>(*expression, names);
+
+  const size_t batch = ColumnKernel::batchSize;
+  std::vector<int64_t> x(batch * 3 + 5);
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = static_cast<int64_t>(i % 19) - 9;
+  }
+  std::vector<int64_t> expected(x.size());
+  kernel->run(std::vector<std::span<const int64_t>>{x}, expected);
+
+  std::vector<int64_t> sliced(x.size());
+  std::vector<int64_t> whole(x.size());
+  std::vector<int64_t> limited(x.size(), -1);
+
+  Scheduler scheduler{};
+  [[maybe_unused]] TaskId slicedId =
+      scheduler.spawn(runKernelTask(kernel, {x}, sliced, 1));
+  TaskId wholeId = scheduler.spawn(runKernelTask(kernel, {x}, whole, 0));
+  TaskId limitedId =
+      scheduler.spawn(runKernelTask(kernel, {x}, limited, 1, 2));
+
+  // nothing runs until the scheduler resumes a task, and a running task
+  // keeps its slot
+  assert(scheduler.result(slicedId).value().status == task_running &&
+         "task ran before it was scheduled");
+  assert(!scheduler.release(slicedId) && scheduler.contains(slicedId) &&
+         "released a task that is still running");
+
+  // one batch per step for the sliced tasks, everything for the other
+  assert(scheduler.step() == 2 && "first step left the wrong tasks running");
+  assert(scheduler.result(wholeId).value().status == task_finished &&
+         "unsliced task did not finish in one step");
+  assert(sliced[batch - 1] == expected[batch - 1] && sliced[batch] == 0 &&
+         "sliced task did not stop after one batch");
+
+  scheduler.run();
+
+  assert(scheduler.result(slicedId).value().status == task_finished &&
+         "sliced task did not finish");
+  assert(sliced == expected && whole == expected &&
+         "scheduled runs differ from a direct run");
+
+  [[maybe_unused]] KernelTaskResult limitedResult =
+      scheduler.result(limitedId).value();
+  assert(limitedResult.status == task_over_quota &&
+         "task ran past its quota");
+  assert(limited[batch * 2 - 1] == expected[batch * 2 - 1] &&
+         limited[batch * 2] == -1 && "quota stopped at the wrong batch");
+
+  // released slots are reused under a new generation, and releasing twice
+  // does not free the slot twice
+  [[maybe_unused]] bool released = scheduler.release(wholeId);
+  assert(released && !scheduler.contains(wholeId) && scheduler.size() == 2 &&
+         "released task is still tracked");
+  assert(!scheduler.release(wholeId) && scheduler.size() == 2 &&
+         "id was released twice");
+  assert(!scheduler.result(wholeId) && "released id still has a result");
+  assert(!scheduler.result(TaskId{99, 0}) &&
+         !scheduler.release(TaskId{99, 0}) &&
+         "id that was never spawned was accepted");
+  std::vector<int64_t> again(x.size());
+  [[maybe_unused]] TaskId againId =
+      scheduler.spawn(runKernelTask(kernel, {x}, again, 0));
+  std::vector<int64_t> other(x.size());
+  [[maybe_unused]] TaskId otherId =
+      scheduler.spawn(runKernelTask(kernel, {x}, other, 0));
+  assert(againId.index == wholeId.index && !scheduler.contains(wholeId) &&
+         "released slot was not reused under a new id");
+  assert(otherId.index != againId.index && scheduler.size() == 4 &&
+         "two tasks share a slot");
+  scheduler.run();
+  assert(scheduler.result(againId).value().status == task_finished &&
+         scheduler.result(otherId).value().status == task_finished &&
+         again == expected && other == expected &&
+         "task in a reused slot did not run");
+
+  // a moved-from task has a defined result
+  KernelTask moved = runKernelTask(kernel, {x}, again, 0);
+  KernelTask owner = std::move(moved);
+  assert(moved.result().status == task_finished && !moved.result().clean &&
+         moved.resume() == task_finished &&
+         "moved-from task did not report a defined result");
+}
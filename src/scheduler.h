@@ -0,0 +1,107 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "column_kernel.h"
+
+enum task_status {
+  task_running,
+  task_finished,
+  task_over_quota,
+};
+
+struct KernelTaskResult {
+  task_status status;
+  // false when a row divided by zero, as ColumnKernel::run returns
+  bool clean;
+};
+
+// A kernel run as a coroutine. It suspends after every slice of batches,
+// so the caller decides when the next slice runs.
+class KernelTask {
+public:
+  struct promise_type {
+    KernelTaskResult result{task_running, true};
+
+    KernelTask get_return_object();
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_value(KernelTaskResult value) { result = value; }
+    void unhandled_exception();
+  };
+
+  explicit KernelTask(std::coroutine_handle<promise_type> handle);
+  KernelTask(KernelTask &&other) noexcept;
+  KernelTask &operator=(KernelTask &&other) noexcept;
+  KernelTask(const KernelTask &) = delete;
+  KernelTask &operator=(const KernelTask &) = delete;
+  ~KernelTask();
+
+  // runs one slice, a no-op once the task has stopped
+  task_status resume();
+  // a moved-from task has no coroutine and reports task_finished, not clean
+  KernelTaskResult result() const;
+
+private:
+  std::coroutine_handle<promise_type> m_handle;
+};
+
+// sliceBatches is how many batches run per resume() and quotaBatches how
+// many the task may run in total; 0 means no limit for either. A task over
+// its quota stops with the rows it did not reach left untouched.
+KernelTask runKernelTask(std::shared_ptr<const ColumnKernel> kernel,
+                         std::vector<std::span<const int64_t>> columns,
+                         std::span<int64_t> output, size_t sliceBatches,
+                         size_t quotaBatches = 0);
+
+// Names a task spawned on a Scheduler. The generation changes whenever the
+// slot is reused, so an id kept after release() never finds the new task.
+struct TaskId {
+  uint32_t index;
+  uint32_t generation;
+};
+
+// Round-robin over kernel tasks on the calling thread. A host wanting more
+// cores runs one scheduler per worker thread. A task that stops is reaped
+// on the step it stops: its coroutine frame is destroyed and only its
+// result is kept until the caller releases the id.
+class Scheduler {
+private:
+  struct Slot {
+    std::optional<KernelTask> task{};
+    KernelTaskResult result{task_running, true};
+    uint32_t generation{0};
+    bool live{false};
+  };
+
+  std::vector<Slot> m_slots{};
+  std::vector<uint32_t> m_free{};
+
+public:
+  TaskId spawn(KernelTask task);
+  // resumes each running task once, returns how many are still running
+  size_t step();
+  // steps until every task has finished or run out of quota
+  void run();
+  // false once the id has been released
+  bool contains(TaskId id) const;
+  // task_running until the task has been reaped, nullopt for an id that
+  // was released or never spawned
+  std::optional<KernelTaskResult> result(TaskId id) const;
+  // frees a stopped task's slot for a later spawn. Returns false, changing
+  // nothing, for an id that is not contained or a task still running.
+  bool release(TaskId id);
+  // tasks spawned and not yet released
+  size_t size() const;
+};
+
+void testScheduler();
+
+#endif // SCHEDULER_H
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "lexer.h"
+#include "source.h"
+
+std::vector<uint32_t> scanLineStartsScalar(std::string_view source) {
+  std::vector<uint32_t> starts{0};
+  for (size_t i = 0; i < source.size(); i++) {
+    if (source[i] == '\n') {
+      starts.push_back(static_cast<uint32_t>(i + 1));
+    }
+  }
+  return starts;
+}
+
+std::vector<uint32_t> scanLineStarts(std::string_view source) {
+#ifdef __SSE2__
+  std::vector<uint32_t> starts{0};
+  const char *data = source.data();
+  const size_t size = source.size();
+  const __m128i newline = _mm_set1_epi8('\n');
+  size_t i = 0;
+
+  // compare 16 bytes at a time and walk the set bits of the match mask
+  for (; i + 16 <= size; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    unsigned mask = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+    while (mask != 0) {
+      starts.push_back(static_cast<uint32_t>(i + __builtin_ctz(mask) + 1));
+      mask &= mask - 1;
+    }
+  }
+
+  for (; i < size; i++) {
+    if (data[i] == '\n') {
+      starts.push_back(static_cast<uint32_t>(i + 1));
+    }
+  }
+  return starts;
+#else
+  return scanLineStartsScalar(source);
+#endif
+}
+
+LineIndex::LineIndex(std::string_view source)
+    : m_lineStarts(scanLineStarts(source)) {}
+
+SourceLocation LineIndex::locate(uint32_t offset) const {
+  // first line start past the offset, the line we want is the one before it
+  auto next =
+      std::upper_bound(m_lineStarts.begin(), m_lineStarts.end(), offset);
+  size_t line = static_cast<size_t>(next - m_lineStarts.begin());
+  uint32_t column = offset - m_lineStarts[line - 1];
+  return SourceLocation{static_cast<uint32_t>(line), column + 1};
+}
+
+size_t LineIndex::lineCount() const { return m_lineStarts.size(); }
+
+void testLineIndex() {
+  // long enough to cross several 16 byte blocks
+  std::string input = "let five = 5;\n"
+                      "let ten = 10;\n"
+                      "\n"
+                      "let add = fn(x, y) { x + y; };\n"
+                      "let result = add(five, ten);";
+
+  assert(scanLineStarts(input) == scanLineStartsScalar(input) &&
+         "vectorized line scan does not match scalar scan");
+
+  LineIndex index(input);
+  assert(index.lineCount() == 5 && "line index has the wrong number of lines");
+
+  [[maybe_unused]] SourceLocation start = index.locate(0);
+  assert(start.line == 1 && start.column == 1 && "offset 0 is not 1:1");
+
+  [[maybe_unused]] SourceLocation add =
+      index.locate(static_cast<uint32_t>(input.find("add")));
+  assert(add.line == 4 && add.column == 5 && "add is not at 4:5");
+
+  Lexer lexer(input);
+  Token tok{};
+  while ((tok = lexer.nextToken()).type != token_type::eof) {
+    if (tok.literal == "result") {
+      break;
+    }
+  }
+
+  assert(tok.literal == "result" && "lexer did not reach result");
+  assert(tok.offset == input.find("result") &&
+         "token offset does not point at its literal");
+
+  [[maybe_unused]] SourceLocation result = lexer.location(tok.offset);
+  assert(result.line == 5 && result.column == 5 && "result is not at 5:5");
+}
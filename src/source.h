@@ -0,0 +1,32 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// 1-based line and column (in bytes) of a position in the source
+struct SourceLocation {
+  uint32_t line;
+  uint32_t column;
+};
+
+// Maps byte offsets to line/column. Tokens only carry an offset, so the
+// newline scan is paid once, the first time a location is asked for.
+class LineIndex {
+private:
+  std::vector<uint32_t> m_lineStarts;
+
+public:
+  explicit LineIndex(std::string_view source);
+  SourceLocation locate(uint32_t offset) const;
+  size_t lineCount() const;
+};
+
+// offsets where each line begins, always starting with 0
+std::vector<uint32_t> scanLineStarts(std::string_view source);
+std::vector<uint32_t> scanLineStartsScalar(std::string_view source);
+
+void testLineIndex();
+
+#endif // SOURCE_H
@@ -1,8 +1,11 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
-#include <map>
+#include <concepts>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 
 enum token_type {
   illegal,
@@ -32,18 +35,46 @@ enum token_type {
   false_T,
   equal,
   not_equal,
+  string_T,
+  import_T,
 };
 
 struct Token {
   token_type type;
-  std::string literal;
+  // static text for operators and keywords, otherwise a view into the
+  // lexer's LiteralPool
+  std::string_view literal;
+  // byte offset of the first character of the token in the lexer input
+  uint32_t offset;
 
   Token();
-  Token(const token_type type, std::string literal);
+  // literal is not copied: it must be static text or come from a
+  // LiteralPool that outlives the token
+  Token(const token_type type, std::string_view literal, uint32_t offset = 0);
+  // a temporary string would be destroyed before the token is used; a
+  // template so string literals still pick the string_view constructor
+  template <typename Text>
+    requires std::same_as<Text, std::string>
+  Token(const token_type type, Text &&literal, uint32_t offset = 0) = delete;
 
   void print() const;
 };
 
-token_type getKeyword(std::string word);
+// a plain table, so keywords can be looked up in constant evaluation
+constexpr token_type getKeyword(std::string_view word) {
+  constexpr std::pair<std::string_view, token_type> keywords[] = {
+      {"fn", token_type::function},     {"let", token_type::let},
+      {"true", token_type::true_T},     {"false", token_type::false_T},
+      {"if", token_type::if_T},         {"else", token_type::else_T},
+      {"return", token_type::return_T}, {"import", token_type::import_T},
+  };
+
+  for (const auto &[text, type] : keywords) {
+    if (text == word) {
+      return type;
+    }
+  }
+  return token_type::identifier;
+}
 
 #endif // TOKEN_H